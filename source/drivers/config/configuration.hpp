@@ -30,6 +30,16 @@ namespace Chimera::Config
   #define CHIMERA_DRIVER_INF_LIFETIME ( CHIMERA_ENABLE )
   #endif
 
+  // Default disable DMA transfer telemetry. Enabling costs RAM for counters and histograms.
+  #ifndef CHIMERA_DMA_TELEMETRY
+  #define CHIMERA_DMA_TELEMETRY ( CHIMERA_DISABLE )
+  #endif
+
+  // Default enable vector kernels for batch ADC processing when the target supports SSE2 or NEON
+  #ifndef CHIMERA_ADC_SIMD
+  #define CHIMERA_ADC_SIMD ( CHIMERA_ENABLE )
+  #endif
+
   /**
    *  There are several different models for how a particular peripheral
    *  driver could be created. On the one hand, a new instance is made each
@@ -0,0 +1,269 @@
+/********************************************************************************
+ *  File Name:
+ *    lockfree_queue.hpp
+ *
+ *  Description:
+ *    Bounded lock-free queues that are safe to use from both threads and ISRs
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CONTAINER_LOCKFREE_QUEUE_HPP
+#define CHIMERA_CONTAINER_LOCKFREE_QUEUE_HPP
+
+/* STL Includes */
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Chimera::Container
+{
+  /**
+   *  Bounded multi-producer, single-consumer queue. Each cell carries a
+   *  sequence number that tells producers and the consumer whose turn it is,
+   *  so pushing never takes a lock and can be done from an ISR.
+   *
+   *  A producer that is preempted between claiming a cell and publishing it
+   *  only delays the consumer, who sees an empty queue until the producer
+   *  resumes. No one ever blocks.
+   *
+   *  @note Requires lock-free std::atomic<size_t>. Cores without exclusive
+   *        load/store instructions (Cortex-M0) fall back on the compiler's
+   *        atomic library, which may mask interrupts.
+   *
+   *  @tparam T       Element type. Must be default constructible and copy assignable.
+   *  @tparam SIZE    Number of elements. Must be a power of two.
+   */
+  template<typename T, size_t SIZE>
+  class MPSCQueue
+  {
+  public:
+    static_assert( ( SIZE >= 2 ) && ( ( SIZE & ( SIZE - 1 ) ) == 0 ) );
+    static_assert( std::is_default_constructible_v<T> && std::is_copy_assignable_v<T> );
+
+    MPSCQueue()
+    {
+      clear();
+    }
+
+    /**
+     *  Resets the queue to empty. Not safe to call while other
+     *  producers or the consumer are active.
+     *
+     *  @return void
+     */
+    void clear()
+    {
+      for ( size_t idx = 0; idx < SIZE; idx++ )
+      {
+        mCells[ idx ].sequence.store( idx, std::memory_order_relaxed );
+      }
+
+      mHead.store( 0, std::memory_order_relaxed );
+      mTail.store( 0, std::memory_order_release );
+    }
+
+    /**
+     *  Pushes an element. Safe from any number of threads and ISRs.
+     *
+     *  @param[in]  data      Element to push
+     *  @return bool          False if the queue is full
+     */
+    bool push( const T &data )
+    {
+      size_t pos = mTail.load( std::memory_order_relaxed );
+
+      while ( true )
+      {
+        Cell &cell      = mCells[ pos & MASK ];
+        size_t seq      = cell.sequence.load( std::memory_order_acquire );
+        intptr_t offset = static_cast<intptr_t>( seq ) - static_cast<intptr_t>( pos );
+
+        if ( offset == 0 )
+        {
+          if ( mTail.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+          {
+            cell.data = data;
+            cell.sequence.store( pos + 1, std::memory_order_release );
+            return true;
+          }
+        }
+        else if ( offset < 0 )
+        {
+          return false;
+        }
+        else
+        {
+          pos = mTail.load( std::memory_order_relaxed );
+        }
+      }
+    }
+
+    /**
+     *  Pops the oldest published element. Only one consumer may call this.
+     *
+     *  @param[out] data      Where to write the element
+     *  @return bool          False if nothing is available
+     */
+    bool pop( T &data )
+    {
+      size_t pos = mHead.load( std::memory_order_relaxed );
+      Cell &cell = mCells[ pos & MASK ];
+      size_t seq = cell.sequence.load( std::memory_order_acquire );
+
+      if ( static_cast<intptr_t>( seq ) - static_cast<intptr_t>( pos + 1 ) < 0 )
+      {
+        return false;
+      }
+
+      data = cell.data;
+      cell.sequence.store( pos + SIZE, std::memory_order_release );
+      mHead.store( pos + 1, std::memory_order_relaxed );
+      return true;
+    }
+
+    /**
+     *  Approximate number of queued elements. Only exact when
+     *  no producers are active.
+     *
+     *  @return size_t
+     */
+    size_t size() const
+    {
+      size_t head = mHead.load( std::memory_order_relaxed );
+      size_t tail = mTail.load( std::memory_order_relaxed );
+      return tail - head;
+    }
+
+    bool empty() const
+    {
+      return size() == 0;
+    }
+
+    static constexpr size_t capacity()
+    {
+      return SIZE;
+    }
+
+  private:
+    static constexpr size_t MASK = SIZE - 1;
+
+    struct Cell
+    {
+      std::atomic<size_t> sequence;
+      T data;
+    };
+
+    std::array<Cell, SIZE> mCells;
+    std::atomic<size_t> mTail; /**< Next position producers will claim */
+    std::atomic<size_t> mHead; /**< Next position the consumer will read */
+  };
+
+
+  /**
+   *  Bounded single-producer, single-consumer ring buffer. The producer may be
+   *  an ISR and the consumer a thread, or vice versa, with no locking at all.
+   *
+   *  @tparam T       Element type. Must be default constructible and copy assignable.
+   *  @tparam SIZE    Number of elements. Must be a power of two.
+   */
+  template<typename T, size_t SIZE>
+  class SPSCQueue
+  {
+  public:
+    static_assert( ( SIZE >= 2 ) && ( ( SIZE & ( SIZE - 1 ) ) == 0 ) );
+    static_assert( std::is_default_constructible_v<T> && std::is_copy_assignable_v<T> );
+
+    SPSCQueue()
+    {
+      clear();
+    }
+
+    /**
+     *  Resets the queue to empty. Not safe to call while the
+     *  producer or consumer are active.
+     *
+     *  @return void
+     */
+    void clear()
+    {
+      mHead.store( 0, std::memory_order_relaxed );
+      mTail.store( 0, std::memory_order_release );
+    }
+
+    /**
+     *  Pushes an element. Only the producer may call this.
+     *
+     *  @param[in]  data      Element to push
+     *  @return bool          False if the queue is full
+     */
+    bool push( const T &data )
+    {
+      size_t tail = mTail.load( std::memory_order_relaxed );
+
+      if ( ( tail - mHead.load( std::memory_order_acquire ) ) >= SIZE )
+      {
+        return false;
+      }
+
+      mCells[ tail & MASK ] = data;
+      mTail.store( tail + 1, std::memory_order_release );
+      return true;
+    }
+
+    /**
+     *  Pops the oldest element. Only the consumer may call this.
+     *
+     *  @param[out] data      Where to write the element
+     *  @return bool          False if nothing is available
+     */
+    bool pop( T &data )
+    {
+      size_t head = mHead.load( std::memory_order_relaxed );
+
+      if ( head == mTail.load( std::memory_order_acquire ) )
+      {
+        return false;
+      }
+
+      data = mCells[ head & MASK ];
+      mHead.store( head + 1, std::memory_order_release );
+      return true;
+    }
+
+    /**
+     *  Approximate number of queued elements
+     *
+     *  @return size_t
+     */
+    size_t size() const
+    {
+      size_t head = mHead.load( std::memory_order_acquire );
+      size_t tail = mTail.load( std::memory_order_acquire );
+      return tail - head;
+    }
+
+    bool empty() const
+    {
+      return size() == 0;
+    }
+
+    static constexpr size_t capacity()
+    {
+      return SIZE;
+    }
+
+  private:
+    static constexpr size_t MASK = SIZE - 1;
+
+    std::array<T, SIZE> mCells;
+    std::atomic<size_t> mTail; /**< Next position the producer will write */
+    std::atomic<size_t> mHead; /**< Next position the consumer will read */
+  };
+
+}  // namespace Chimera::Container
+
+#endif /* !CHIMERA_CONTAINER_LOCKFREE_QUEUE_HPP */
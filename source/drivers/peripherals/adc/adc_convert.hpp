@@ -0,0 +1,73 @@
+/********************************************************************************
+ *  File Name:
+ *    adc_convert.hpp
+ *
+ *  Description:
+ *    Batch conversion of raw ADC counts into calibrated voltages
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_ADC_CONVERT_HPP
+#define CHIMERA_ADC_CONVERT_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/adc/adc_types.hpp>
+
+namespace Chimera::ADC
+{
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Gets the full scale reading of a conversion resolution
+   *
+   *  @param[in]  resolution    Converter resolution
+   *  @return size_t            Max counts, or zero if the resolution is unknown
+   */
+  size_t fullScaleCounts( const Resolution resolution );
+
+  /**
+   *  Converts a run of raw counts into volts. Uses SSE2 or NEON kernels when
+   *  available and CHIMERA_ADC_SIMD is enabled, otherwise a scalar loop.
+   *
+   *  Unlike IADC::toVoltage(), there is no virtual dispatch per sample, so
+   *  prefer this for streamed data.
+   *
+   *  @param[in]  cal           Calibration to apply
+   *  @param[in]  counts        Raw conversion results
+   *  @param[out] volts         Converted output, may not alias counts
+   *  @param[in]  length        Number of elements in both buffers
+   *  @return void
+   */
+  void toVoltage( const Calibration &cal, const uint16_t *const counts, float *const volts, const size_t length );
+
+  /**
+   *  Precomputes the integer form of a calibration. Call once at startup on
+   *  targets with an FPU, or generate offline for targets without one.
+   *
+   *  @param[in]  cal           Floating point calibration
+   *  @return FixedCalibration
+   */
+  FixedCalibration toFixedCalibration( const Calibration &cal );
+
+  /**
+   *  Converts a run of raw counts into microvolts using only integer math
+   *
+   *  @param[in]  cal           Calibration to apply
+   *  @param[in]  counts        Raw conversion results
+   *  @param[out] microvolts    Converted output
+   *  @param[in]  length        Number of elements in both buffers
+   *  @return void
+   */
+  void toMicrovolts( const FixedCalibration &cal, const uint16_t *const counts, int32_t *const microvolts,
+                     const size_t length );
+}  // namespace Chimera::ADC
+
+#endif /* !CHIMERA_ADC_CONVERT_HPP */
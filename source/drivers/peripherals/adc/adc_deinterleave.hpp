@@ -0,0 +1,375 @@
+/********************************************************************************
+ *  File Name:
+ *    adc_deinterleave.hpp
+ *
+ *  Description:
+ *    Splits interleaved sequence conversions into per-channel ring buffers
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_ADC_DEINTERLEAVE_HPP
+#define CHIMERA_ADC_DEINTERLEAVE_HPP
+
+/* STL Includes */
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/container>
+#include <Chimera/source/drivers/peripherals/adc/adc_packed.hpp>
+#include <Chimera/source/drivers/peripherals/adc/adc_types.hpp>
+
+/*-------------------------------------------------------------------------------
+Literals
+-------------------------------------------------------------------------------*/
+/**
+ *  Number of blocks each channel ring can describe at once. Must be a power of
+ *  two. A ring holds whatever fits in its sample capacity up to this many blocks.
+ */
+#ifndef CHIMERA_ADC_DEINTERLEAVE_BLOCKS
+#define CHIMERA_ADC_DEINTERLEAVE_BLOCKS ( 8 )
+#endif
+
+namespace Chimera::ADC
+{
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Lock free single producer, single consumer ring of conversions from one
+   *  channel. Blocks are accepted whole or not at all, which keeps the timestamp
+   *  of every sample exact without storing it per sample.
+   *
+   *  @tparam CAPACITY        Sample capacity, must be a power of two
+   */
+  template<size_t CAPACITY>
+  class ChannelRing
+  {
+  public:
+    static_assert( ( CAPACITY >= 2 ) && ( ( CAPACITY & ( CAPACITY - 1 ) ) == 0 ) );
+
+    ChannelRing()
+    {
+      clear();
+    }
+
+    /**
+     *  Resets the ring to empty. Not safe to call while the
+     *  producer or consumer are active.
+     *
+     *  @return void
+     */
+    void clear()
+    {
+      mBlocks.clear();
+      mCurrent   = {};
+      mRemaining = 0;
+      mConsumed  = 0;
+      mDropped.store( 0, std::memory_order_relaxed );
+      mHead.store( 0, std::memory_order_relaxed );
+      mTail.store( 0, std::memory_order_release );
+    }
+
+    /**
+     *  Copies every stride'th conversion into the ring. Producer only.
+     *
+     *  @param[in]  src         First conversion belonging to this channel
+     *  @param[in]  stride      Distance between conversions of this channel
+     *  @param[in]  count       Number of conversions
+     *  @param[in]  us          Timestamp of the first conversion
+     *  @param[in]  periodUs    Time between conversions
+     *  @return bool            False if the block was dropped for lack of space
+     */
+    bool write( const uint16_t *const src, const size_t stride, const size_t count, const size_t us,
+                const size_t periodUs )
+    {
+      const size_t tail = mTail.load( std::memory_order_relaxed );
+
+      if ( !count )
+      {
+        return true;
+      }
+
+      /*-------------------------------------------------
+      Only the consumer shrinks either queue, so seeing
+      room here guarantees the pushes below succeed.
+      -------------------------------------------------*/
+      if ( ( count > ( CAPACITY - ( tail - mHead.load( std::memory_order_acquire ) ) ) ) ||
+           ( mBlocks.size() >= mBlocks.capacity() ) )
+      {
+        mDropped.fetch_add( 1, std::memory_order_relaxed );
+        return false;
+      }
+
+      /*-------------------------------------------------
+      Data and tail first, then the block header, so the
+      consumer never sees a header without its data.
+      -------------------------------------------------*/
+      const size_t offset = tail & MASK;
+      const size_t first  = ( count < ( CAPACITY - offset ) ) ? count : ( CAPACITY - offset );
+
+      copyStrided( mData.data() + offset, src, stride, first );
+      copyStrided( mData.data(), src + ( first * stride ), stride, count - first );
+
+      mTail.store( tail + count, std::memory_order_release );
+      mBlocks.push( Header{ us, periodUs, count } );
+      return true;
+    }
+
+    /**
+     *  Pops the oldest conversion with its timestamp. Consumer only.
+     *
+     *  @param[out] sample      Where to write the sample
+     *  @return bool            False if nothing is available
+     */
+    bool pop( Sample &sample )
+    {
+      if ( !mRemaining && !nextHeader() )
+      {
+        return false;
+      }
+
+      const size_t head = mHead.load( std::memory_order_relaxed );
+      sample.us         = mCurrent.us + ( mConsumed * mCurrent.periodUs );
+      sample.counts     = mData[ head & MASK ];
+
+      mConsumed++;
+      mRemaining--;
+      mHead.store( head + 1, std::memory_order_release );
+      return true;
+    }
+
+    /**
+     *  Copies out up to length raw conversions. Consumer only.
+     *
+     *  @param[out] dst         Output buffer
+     *  @param[in]  length      Size of the output buffer
+     *  @return size_t          Number of conversions copied
+     */
+    size_t read( uint16_t *const dst, const size_t length )
+    {
+      size_t copied = 0;
+
+      while ( ( copied < length ) && ( mRemaining || nextHeader() ) )
+      {
+        const size_t head   = mHead.load( std::memory_order_relaxed );
+        const size_t offset = head & MASK;
+
+        size_t chunk = length - copied;
+        chunk        = ( chunk < mRemaining ) ? chunk : mRemaining;
+        chunk        = ( chunk < ( CAPACITY - offset ) ) ? chunk : ( CAPACITY - offset );
+
+        memcpy( dst + copied, mData.data() + offset, chunk * sizeof( uint16_t ) );
+
+        copied += chunk;
+        mConsumed += chunk;
+        mRemaining -= chunk;
+        mHead.store( head + chunk, std::memory_order_release );
+      }
+
+      return copied;
+    }
+
+    /**
+     *  Approximate number of unread conversions
+     *  @return size_t
+     */
+    size_t available() const
+    {
+      return mTail.load( std::memory_order_acquire ) - mHead.load( std::memory_order_acquire );
+    }
+
+    /**
+     *  Number of blocks rejected because the consumer fell behind
+     *  @return size_t
+     */
+    size_t dropped() const
+    {
+      return mDropped.load( std::memory_order_relaxed );
+    }
+
+    static constexpr size_t capacity()
+    {
+      return CAPACITY;
+    }
+
+  private:
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    struct Header
+    {
+      size_t us;
+      size_t periodUs;
+      size_t count;
+    };
+
+    std::array<uint16_t, CAPACITY> mData;
+    Chimera::Container::SPSCQueue<Header, CHIMERA_ADC_DEINTERLEAVE_BLOCKS> mBlocks;
+    std::atomic<size_t> mHead;
+    std::atomic<size_t> mTail;
+    std::atomic<size_t> mDropped;
+
+    /*-------------------------------------------------
+    Consumer only state
+    -------------------------------------------------*/
+    Header mCurrent;   /**< Block currently being read */
+    size_t mRemaining; /**< Unread conversions in the current block */
+    size_t mConsumed;  /**< Conversions already read from the current block */
+
+    bool nextHeader()
+    {
+      if ( !mBlocks.pop( mCurrent ) )
+      {
+        return false;
+      }
+
+      mRemaining = mCurrent.count;
+      mConsumed  = 0;
+      return true;
+    }
+  };
+
+
+  /**
+   *  Splits the interleaved blocks produced by a sequence stream into one ring
+   *  per channel, so each consumer reads only its own channel in O(1) per sample
+   *  instead of searching the sequence.
+   *
+   *  The producer side (push) may run in an ISR or stream thread. Each channel
+   *  ring may be drained by a different consumer, but only one per channel.
+   *
+   *  @tparam MAX_CHANNELS    Longest sequence supported
+   *  @tparam CAPACITY        Samples buffered per channel, a power of two
+   */
+  template<size_t MAX_CHANNELS, size_t CAPACITY>
+  class Deinterleaver
+  {
+  public:
+    Deinterleaver() : mNumChannels( 0 )
+    {
+      mLookup.fill( INVALID );
+    }
+
+    /**
+     *  Maps the channels of a sequence onto rings. Not safe to call while the
+     *  producer or consumers are active.
+     *
+     *  @param[in]  sequence      Sequence that generates the blocks
+     *  @return Chimera::Status_t INVAL_FUNC_PARAM if the sequence doesn't fit
+     */
+    Chimera::Status_t configure( const SequenceInit &sequence )
+    {
+      if ( !sequence.channels || !sequence.numChannels || ( sequence.numChannels > MAX_CHANNELS ) ||
+           ( sequence.numChannels > sequence.channels->size() ) )
+      {
+        return Chimera::Status::INVAL_FUNC_PARAM;
+      }
+
+      mLookup.fill( INVALID );
+      mNumChannels = sequence.numChannels;
+
+      for ( size_t idx = 0; idx < mNumChannels; idx++ )
+      {
+        const size_t ch = EnumValue( ( *sequence.channels )[ idx ] );
+        if ( ch >= mLookup.size() )
+        {
+          mNumChannels = 0;
+          return Chimera::Status::INVAL_FUNC_PARAM;
+        }
+
+        /*-------------------------------------------------
+        A channel listed twice only gets its first slot
+        -------------------------------------------------*/
+        if ( mLookup[ ch ] == INVALID )
+        {
+          mLookup[ ch ] = idx;
+        }
+
+        mRings[ idx ].clear();
+      }
+
+      return Chimera::Status::OK;
+    }
+
+    /**
+     *  Distributes a block across the channel rings
+     *
+     *  @param[in]  block       Interleaved stream block
+     *  @return size_t          Number of channels that accepted the block
+     */
+    size_t push( const SampleBlock &block )
+    {
+      if ( !block.counts || ( block.numChannels != mNumChannels ) )
+      {
+        return 0;
+      }
+
+      size_t accepted = 0;
+      for ( size_t idx = 0; idx < mNumChannels; idx++ )
+      {
+        accepted += mRings[ idx ].write( block.counts + idx, mNumChannels, block.numScans, block.us, block.periodUs );
+      }
+
+      return accepted;
+    }
+
+    /**
+     *  Pops the oldest sample of a channel
+     *
+     *  @param[in]  ch          Channel to read
+     *  @param[out] sample      Where to write the sample
+     *  @return bool            False if nothing is available
+     */
+    bool nextSample( const Channel ch, Sample &sample )
+    {
+      auto ring = find( ch );
+      return ring ? ring->pop( sample ) : false;
+    }
+
+    /**
+     *  Copies out raw conversions of a channel
+     *
+     *  @param[in]  ch          Channel to read
+     *  @param[out] dst         Output buffer
+     *  @param[in]  length      Size of the output buffer
+     *  @return size_t          Number of conversions copied
+     */
+    size_t read( const Channel ch, uint16_t *const dst, const size_t length )
+    {
+      auto ring = find( ch );
+      return ( ring && dst ) ? ring->read( dst, length ) : 0;
+    }
+
+    /**
+     *  Gets the ring of a channel for direct access
+     *
+     *  @param[in]  ch          Channel to look up
+     *  @return ChannelRing<CAPACITY> *   nullptr if not in the sequence
+     */
+    ChannelRing<CAPACITY> *find( const Channel ch )
+    {
+      const size_t key = EnumValue( ch );
+      if ( ( key >= mLookup.size() ) || ( mLookup[ key ] == INVALID ) )
+      {
+        return nullptr;
+      }
+
+      return &mRings[ mLookup[ key ] ];
+    }
+
+  private:
+    static constexpr size_t INVALID = ~static_cast<size_t>( 0 );
+
+    std::array<ChannelRing<CAPACITY>, MAX_CHANNELS> mRings;
+    std::array<size_t, EnumValue( Channel::NUM_OPTIONS )> mLookup;
+    size_t mNumChannels;
+  };
+}  // namespace Chimera::ADC
+
+#endif /* !CHIMERA_ADC_DEINTERLEAVE_HPP */
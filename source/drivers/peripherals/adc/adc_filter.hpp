@@ -0,0 +1,442 @@
+/********************************************************************************
+ *  File Name:
+ *    adc_filter.hpp
+ *
+ *  Description:
+ *    Allocation free signal conditioning pipeline for blocks of ADC data. Each
+ *    stage processes a whole block of voltages in place, and stages can be
+ *    chained together with a Pipeline.
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_ADC_FILTER_HPP
+#define CHIMERA_ADC_FILTER_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+
+namespace Chimera::ADC::Filter
+{
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct Statistics
+  {
+    float min;    /**< Smallest value seen */
+    float max;    /**< Largest value seen */
+    float mean;   /**< Arithmetic mean */
+    float rms;    /**< Root mean square */
+    size_t count; /**< Number of values accumulated */
+
+    void clear()
+    {
+      min   = 0.0f;
+      max   = 0.0f;
+      mean  = 0.0f;
+      rms   = 0.0f;
+      count = 0;
+    }
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Number of bits needed to represent values up to ( value - 1 )
+   *
+   *  @param[in]  value       Value to take the log of
+   *  @return size_t
+   */
+  constexpr size_t ceilLog2( const size_t value )
+  {
+    size_t bits = 0;
+    while ( ( static_cast<size_t>( 1 ) << bits ) < value )
+    {
+      bits++;
+    }
+
+    return bits;
+  }
+
+  /**
+   *  Vectorized dot product of two float arrays
+   *
+   *  @param[in]  a           First operand
+   *  @param[in]  b           Second operand
+   *  @param[in]  length      Number of elements in each
+   *  @return float
+   */
+  float dotProduct( const float *const a, const float *const b, const size_t length );
+
+  /**
+   *  Vectorized accumulation of the running min, max, sum and sum of squares
+   *  of a block. The min/max outputs must be seeded by the caller. Sums are
+   *  single precision, so keep blocks short and combine them with a
+   *  compensated sum, as StatisticsStage does.
+   *
+   *  @param[in]  data        Block to scan
+   *  @param[in]  length      Number of elements
+   *  @param[in,out] min      Running minimum
+   *  @param[in,out] max      Running maximum
+   *  @param[in,out] sum      Running sum
+   *  @param[in,out] sumSq    Running sum of squares
+   *  @return void
+   */
+  void accumulate( const float *const data, const size_t length, float &min, float &max, float &sum, float &sumSq );
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  A single processing step. Stages keep whatever history they need between
+   *  blocks, so a stream may be fed in arbitrarily sized pieces.
+   */
+  class IStage
+  {
+  public:
+    virtual ~IStage() = default;
+
+    /**
+     *  Processes a block in place
+     *
+     *  @param[in,out] data     Block to process
+     *  @param[in]  length      Number of valid elements in the block
+     *  @return size_t          Number of valid elements after processing
+     */
+    virtual size_t process( float *const data, const size_t length ) = 0;
+
+    /**
+     *  Discards all history
+     *  @return void
+     */
+    virtual void reset() = 0;
+  };
+
+
+  /**
+   *  Runs blocks through a fixed number of stages in the order they were added.
+   *  The pipeline does not own the stages.
+   *
+   *  @tparam MAX_STAGES      Stage capacity
+   */
+  template<size_t MAX_STAGES>
+  class Pipeline
+  {
+  public:
+    Pipeline() : mNumStages( 0 )
+    {
+      mStages.fill( nullptr );
+    }
+
+    /**
+     *  Appends a stage to the end of the pipeline
+     *
+     *  @param[in]  stage       Stage to append
+     *  @return bool            False if the pipeline is full
+     */
+    bool append( IStage *const stage )
+    {
+      if ( !stage || ( mNumStages >= MAX_STAGES ) )
+      {
+        return false;
+      }
+
+      mStages[ mNumStages++ ] = stage;
+      return true;
+    }
+
+    size_t process( float *const data, size_t length )
+    {
+      for ( size_t idx = 0; ( idx < mNumStages ) && length; idx++ )
+      {
+        length = mStages[ idx ]->process( data, length );
+      }
+
+      return length;
+    }
+
+    void reset()
+    {
+      for ( size_t idx = 0; idx < mNumStages; idx++ )
+      {
+        mStages[ idx ]->reset();
+      }
+    }
+
+  private:
+    std::array<IStage *, MAX_STAGES> mStages;
+    size_t mNumStages;
+  };
+
+
+  /**
+   *  Moving average over the last WINDOW samples. Output is the same length as
+   *  the input. The running sum is rebuilt from the history once per window,
+   *  so single precision rounding can't accumulate into drift.
+   *
+   *  @tparam WINDOW          Averaging window length
+   */
+  template<size_t WINDOW>
+  class Boxcar : public IStage
+  {
+  public:
+    static_assert( WINDOW > 0 );
+
+    Boxcar()
+    {
+      reset();
+    }
+
+    size_t process( float *const data, const size_t length ) final override
+    {
+      constexpr float scale = 1.0f / static_cast<float>( WINDOW );
+
+      for ( size_t idx = 0; idx < length; idx++ )
+      {
+        mSum += data[ idx ] - mHistory[ mPos ];
+        mHistory[ mPos ] = data[ idx ];
+        data[ idx ]      = mSum * scale;
+
+        if ( ++mPos >= WINDOW )
+        {
+          mPos = 0;
+          mSum = 0.0f;
+
+          for ( const float value : mHistory )
+          {
+            mSum += value;
+          }
+        }
+      }
+
+      return length;
+    }
+
+    void reset() final override
+    {
+      mHistory.fill( 0.0f );
+      mSum = 0.0f;
+      mPos = 0;
+    }
+
+  private:
+    std::array<float, WINDOW> mHistory;
+    float mSum;
+    size_t mPos;
+  };
+
+
+  /**
+   *  Cascaded integrator-comb decimator with ORDER integrators at the input
+   *  rate, decimation by RATIO, then ORDER combs at the output rate. The output
+   *  is normalized to unity DC gain.
+   *
+   *  Samples are quantized to fixed point with FRACTION_BITS fractional bits,
+   *  so inputs must stay within +/-2^( 31 - FRACTION_BITS ). The integrators
+   *  are 64-bit and allowed to wrap: the combs undo the overflow exactly, the
+   *  same as in a hardware CIC. Nothing runs in double precision, which is
+   *  emulated in software on single precision FPUs.
+   *
+   *  The block shrinks by a factor of RATIO, with any remainder carried into
+   *  the next call.
+   *
+   *  @tparam ORDER           Number of cascaded sections
+   *  @tparam RATIO           Decimation ratio
+   *  @tparam FRACTION_BITS   Fixed point resolution of the input
+   */
+  template<size_t ORDER, size_t RATIO, size_t FRACTION_BITS = 16>
+  class CICDecimator : public IStage
+  {
+  public:
+    static_assert( ( ORDER > 0 ) && ( RATIO > 0 ) );
+    static_assert( FRACTION_BITS < 31 );
+    static_assert( ( ORDER * ceilLog2( RATIO ) ) <= 32, "Gain doesn't fit in the 64-bit registers" );
+
+    CICDecimator()
+    {
+      reset();
+    }
+
+    size_t process( float *const data, const size_t length ) final override
+    {
+      size_t output = 0;
+
+      for ( size_t idx = 0; idx < length; idx++ )
+      {
+        uint64_t value = static_cast<uint64_t>( static_cast<int64_t>( quantize( data[ idx ] ) ) );
+
+        for ( auto &integrator : mIntegrator )
+        {
+          integrator += value;
+          value = integrator;
+        }
+
+        if ( ++mPhase >= RATIO )
+        {
+          mPhase = 0;
+
+          for ( auto &comb : mComb )
+          {
+            const uint64_t prev = comb;
+            comb                = value;
+            value -= prev;
+          }
+
+          data[ output++ ] = static_cast<float>( static_cast<int64_t>( value ) ) * sGain;
+        }
+      }
+
+      return output;
+    }
+
+    void reset() final override
+    {
+      mIntegrator.fill( 0 );
+      mComb.fill( 0 );
+      mPhase = 0;
+    }
+
+  private:
+    static constexpr float sScale = static_cast<float>( 1u << FRACTION_BITS );
+    static constexpr float sLimit = 2147483520.0f; /**< Largest float below 2^31 */
+
+    static constexpr float computeGain()
+    {
+      float gain = sScale;
+      for ( size_t idx = 0; idx < ORDER; idx++ )
+      {
+        gain *= static_cast<float>( RATIO );
+      }
+
+      return 1.0f / gain;
+    }
+
+    static constexpr float sGain = computeGain();
+
+    static int32_t quantize( const float sample )
+    {
+      float x = sample * sScale;
+      x       = ( x > sLimit ) ? sLimit : ( ( x < -sLimit ) ? -sLimit : x );
+
+      return static_cast<int32_t>( ( x >= 0.0f ) ? ( x + 0.5f ) : ( x - 0.5f ) );
+    }
+
+    std::array<uint64_t, ORDER> mIntegrator;
+    std::array<uint64_t, ORDER> mComb; /**< Integrator output at the previous decimated sample */
+    size_t mPhase;
+  };
+
+
+  /**
+   *  Finite impulse response filter with TAPS coefficients. The delay line is
+   *  stored twice back to back so the most recent TAPS samples are always
+   *  contiguous, letting each output be a single vectorized dot product.
+   *
+   *  @tparam TAPS            Number of filter coefficients
+   */
+  template<size_t TAPS>
+  class FIR : public IStage
+  {
+  public:
+    static_assert( TAPS > 0 );
+
+    FIR()
+    {
+      mCoeffs.fill( 0.0f );
+      reset();
+    }
+
+    /**
+     *  Loads the filter coefficients, where coeffs[ 0 ] multiplies the newest sample
+     *
+     *  @param[in]  coeffs      Coefficients
+     *  @param[in]  length      Number of coefficients, at most TAPS
+     *  @return bool
+     */
+    bool setCoefficients( const float *const coeffs, const size_t length )
+    {
+      if ( !coeffs || !length || ( length > TAPS ) )
+      {
+        return false;
+      }
+
+      /*-------------------------------------------------
+      Reverse so the dot product walks the delay line
+      from oldest to newest.
+      -------------------------------------------------*/
+      mCoeffs.fill( 0.0f );
+      for ( size_t idx = 0; idx < length; idx++ )
+      {
+        mCoeffs[ TAPS - 1 - idx ] = coeffs[ idx ];
+      }
+
+      return true;
+    }
+
+    size_t process( float *const data, const size_t length ) final override
+    {
+      for ( size_t idx = 0; idx < length; idx++ )
+      {
+        mDelay[ mPos ]        = data[ idx ];
+        mDelay[ mPos + TAPS ] = data[ idx ];
+
+        if ( ++mPos >= TAPS )
+        {
+          mPos = 0;
+        }
+
+        data[ idx ] = dotProduct( &mDelay[ mPos ], mCoeffs.data(), TAPS );
+      }
+
+      return length;
+    }
+
+    void reset() final override
+    {
+      mDelay.fill( 0.0f );
+      mPos = 0;
+    }
+
+  private:
+    std::array<float, TAPS> mCoeffs;
+    std::array<float, 2 * TAPS> mDelay;
+    size_t mPos;
+  };
+
+
+  /**
+   *  Pass through stage that tracks min/max/mean/RMS of everything it sees
+   */
+  class StatisticsStage : public IStage
+  {
+  public:
+    StatisticsStage();
+
+    size_t process( float *const data, const size_t length ) final override;
+    void reset() final override;
+
+    /**
+     *  Gets the statistics accumulated since the last reset
+     *  @return Statistics
+     */
+    Statistics statistics() const;
+
+  private:
+    float mMin;
+    float mMax;
+    float mSum;      /**< Compensated running sum */
+    float mSumErr;   /**< Low order bits lost from mSum */
+    float mSumSq;    /**< Compensated running sum of squares */
+    float mSumSqErr; /**< Low order bits lost from mSumSq */
+    size_t mCount;
+  };
+}  // namespace Chimera::ADC::Filter
+
+#endif /* !CHIMERA_ADC_FILTER_HPP */
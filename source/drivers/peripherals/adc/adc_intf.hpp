@@ -137,6 +137,56 @@ namespace Chimera::ADC
      *  @return float
      */
     virtual float toVoltage( const Sample &sample ) = 0;
+
+    /**
+     *  Starts continuous DMA acquisition of a channel sequence. Each time half
+     *  of the circular buffer fills, a SampleBlock becomes available to the
+     *  consumer.
+     *
+     *  @see StreamController
+     *
+     *  @param[in]  init          Stream configuration
+     *  @return Chimera::Status_t NOT_SUPPORTED unless the backend can stream
+     */
+    virtual Chimera::Status_t startStream( const StreamInit &init )
+    {
+      ( void )init;
+      return Chimera::Status::NOT_SUPPORTED;
+    }
+
+    /**
+     *  Stops a running stream. The last unread block remains readable.
+     *  @return void
+     */
+    virtual void stopStream()
+    {
+    }
+
+    /**
+     *  Gets the newest unread block from a running stream. Older unread
+     *  blocks have already been overwritten and are skipped.
+     *
+     *  @param[out] block         Where to write the block
+     *  @return bool              False if nothing is available
+     */
+    virtual bool nextBlock( SampleBlock &block )
+    {
+      ( void )block;
+      return false;
+    }
+
+    /**
+     *  Finishes with a block from nextBlock(). The data was only intact if
+     *  this returns true.
+     *
+     *  @param[in]  block         Block that was processed
+     *  @return bool              False if the hardware may have overwritten the block
+     */
+    virtual bool releaseBlock( const SampleBlock &block )
+    {
+      ( void )block;
+      return false;
+    }
   };
 
 
@@ -0,0 +1,209 @@
+/********************************************************************************
+ *  File Name:
+ *    adc_packed.hpp
+ *
+ *  Description:
+ *    Compact structure-of-arrays storage for blocks of ADC samples
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_ADC_PACKED_HPP
+#define CHIMERA_ADC_PACKED_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/adc/adc_types.hpp>
+
+namespace Chimera::ADC
+{
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Copies every stride'th element of the source into contiguous memory
+   *
+   *  @param[out] dst         Contiguous output
+   *  @param[in]  src         First element to copy
+   *  @param[in]  stride      Distance between consecutive elements, in elements
+   *  @param[in]  count       Number of elements to copy
+   *  @return void
+   */
+  void copyStrided( uint16_t *const dst, const uint16_t *const src, const size_t stride, const size_t count );
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Block of evenly spaced samples from several channels. Rather than storing a
+   *  timestamp with every reading like Sample does, the block holds one base time
+   *  and a sample period. Counts for each channel are stored contiguously, which
+   *  is friendly to batch conversions and vector instructions.
+   *
+   *  A 12-bit reading costs 2 bytes here versus 16 bytes as a Sample on a 64-bit
+   *  host, plus a small fixed header per block.
+   *
+   *  @tparam MAX_CHANNELS    Channel capacity
+   *  @tparam MAX_SAMPLES     Per-channel sample capacity
+   */
+  template<size_t MAX_CHANNELS, size_t MAX_SAMPLES>
+  class PackedBlock
+  {
+  public:
+    static_assert( MAX_CHANNELS && MAX_SAMPLES );
+
+    size_t us;          /**< Timestamp of the first sample in microseconds */
+    size_t periodUs;    /**< Time between consecutive samples of a channel */
+    size_t numChannels; /**< Channels holding valid data */
+    size_t numSamples;  /**< Valid samples in each channel */
+
+    PackedBlock()
+    {
+      clear();
+    }
+
+    void clear()
+    {
+      us          = 0;
+      periodUs    = 0;
+      numChannels = 0;
+      numSamples  = 0;
+    }
+
+    static constexpr size_t channelCapacity()
+    {
+      return MAX_CHANNELS;
+    }
+
+    static constexpr size_t sampleCapacity()
+    {
+      return MAX_SAMPLES;
+    }
+
+    /**
+     *  Gets the contiguous counts of one channel
+     *
+     *  @param[in]  channel     Index of the channel in the block, not the hardware channel
+     *  @return uint16_t *
+     */
+    uint16_t *counts( const size_t channel )
+    {
+      return mCounts[ channel ].data();
+    }
+
+    const uint16_t *counts( const size_t channel ) const
+    {
+      return mCounts[ channel ].data();
+    }
+
+    /**
+     *  Timestamp of a sample in microseconds
+     *
+     *  @param[in]  index       Sample index within the channel
+     *  @return size_t
+     */
+    size_t timestamp( const size_t index ) const
+    {
+      return us + ( index * periodUs );
+    }
+
+    /**
+     *  Fills the block from an interleaved stream block, keeping at most
+     *  sampleCapacity() scans and channelCapacity() channels.
+     *
+     *  @param[in]  src         Stream block to split apart
+     *  @return size_t          Number of samples stored per channel
+     */
+    size_t pack( const SampleBlock &src )
+    {
+      clear();
+
+      if ( !src.counts )
+      {
+        return 0;
+      }
+
+      us          = src.us;
+      periodUs    = src.periodUs;
+      numChannels = ( src.numChannels < MAX_CHANNELS ) ? src.numChannels : MAX_CHANNELS;
+      numSamples  = ( src.numScans < MAX_SAMPLES ) ? src.numScans : MAX_SAMPLES;
+
+      for ( size_t ch = 0; ch < numChannels; ch++ )
+      {
+        copyStrided( mCounts[ ch ].data(), src.counts + ch, src.numChannels, numSamples );
+      }
+
+      return numSamples;
+    }
+
+    /**
+     *  Stores evenly spaced Samples into one channel, starting from the first
+     *  sample index and overwriting what the channel held. Packing into an
+     *  empty block sets the base timestamp. Counts are truncated to 16 bits.
+     *
+     *  @param[in]  channel     Index of the channel in the block
+     *  @param[in]  samples     Samples to store
+     *  @param[in]  count       Number of samples
+     *  @return size_t          Number of samples actually stored
+     */
+    size_t pack( const size_t channel, const Sample *const samples, const size_t count )
+    {
+      if ( ( channel >= MAX_CHANNELS ) || !samples )
+      {
+        return 0;
+      }
+
+      if ( !numChannels && !numSamples && count )
+      {
+        us       = samples[ 0 ].us;
+        periodUs = ( count > 1 ) ? ( samples[ 1 ].us - samples[ 0 ].us ) : 0;
+      }
+
+      size_t stored = 0;
+      for ( ; ( stored < count ) && ( stored < MAX_SAMPLES ); stored++ )
+      {
+        mCounts[ channel ][ stored ] = static_cast<uint16_t>( samples[ stored ].counts );
+      }
+
+      numChannels = ( channel >= numChannels ) ? ( channel + 1 ) : numChannels;
+      numSamples  = ( stored > numSamples ) ? stored : numSamples;
+      return stored;
+    }
+
+    /**
+     *  Expands one channel back into timestamped Samples
+     *
+     *  @param[in]  channel     Index of the channel in the block
+     *  @param[out] samples     Output buffer
+     *  @param[in]  count       Size of the output buffer
+     *  @return size_t          Number of samples written
+     */
+    size_t unpack( const size_t channel, Sample *const samples, const size_t count ) const
+    {
+      if ( ( channel >= numChannels ) || !samples )
+      {
+        return 0;
+      }
+
+      size_t written = 0;
+      for ( ; ( written < count ) && ( written < numSamples ); written++ )
+      {
+        samples[ written ].us     = timestamp( written );
+        samples[ written ].counts = mCounts[ channel ][ written ];
+      }
+
+      return written;
+    }
+
+  private:
+    std::array<std::array<uint16_t, MAX_SAMPLES>, MAX_CHANNELS> mCounts;
+  };
+}  // namespace Chimera::ADC
+
+#endif /* !CHIMERA_ADC_PACKED_HPP */
@@ -0,0 +1,27 @@
+/********************************************************************************
+ *  File Name:
+ *    adc_simd.hpp
+ *
+ *  Description:
+ *    Selects the vector instruction set used by the ADC batch processing code.
+ *    Only included by implementation files.
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_ADC_SIMD_HPP
+#define CHIMERA_ADC_SIMD_HPP
+
+/* Chimera Includes */
+#include <Chimera/cfg>
+
+#if ( CHIMERA_ADC_SIMD == CHIMERA_ENABLE ) && defined( __SSE2__ )
+#include <emmintrin.h>
+#define CHIMERA_ADC_SSE2
+#elif ( CHIMERA_ADC_SIMD == CHIMERA_ENABLE ) && defined( __ARM_NEON )
+#include <arm_neon.h>
+#define CHIMERA_ADC_NEON
+#endif
+
+#endif /* !CHIMERA_ADC_SIMD_HPP */
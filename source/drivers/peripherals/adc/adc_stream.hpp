@@ -0,0 +1,124 @@
+/********************************************************************************
+ *  File Name:
+ *    adc_stream.hpp
+ *
+ *  Description:
+ *    Circular DMA stream management shared by ADC backends
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_ADC_STREAM_HPP
+#define CHIMERA_ADC_STREAM_HPP
+
+/* STL Includes */
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/adc/adc_types.hpp>
+
+namespace Chimera::ADC
+{
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Turns half/full transfer events from a circular DMA buffer into
+   *  SampleBlocks. Backends call onHalfTransfer()/onTransferComplete() from their
+   *  DMA ISR and forward nextBlock()/releaseBlock() from the driver interface.
+   *
+   *  Blocks point into the DMA buffer, and the hardware starts overwriting a
+   *  half as soon as the other half completes. Only the newest half is ever
+   *  intact, so nextBlock() hands out that one and counts any older unread
+   *  blocks as dropped. releaseBlock() then tells the consumer whether the
+   *  hardware wrapped into the block while it was being processed.
+   *
+   *  The ISR is the only producer and the consumer thread the only reader, so
+   *  no locks are taken on either side.
+   */
+  class StreamController
+  {
+  public:
+    StreamController();
+    ~StreamController();
+
+    /**
+     *  Validates and stores the stream configuration, discarding any unread block
+     *
+     *  @param[in]  init          Stream configuration
+     *  @return Chimera::Status_t INVAL_FUNC_PARAM if the buffer can't be split evenly
+     */
+    Chimera::Status_t configure( const StreamInit &init );
+
+    /**
+     *  Stops accepting events. The last unread block stays readable.
+     *  @return void
+     */
+    void reset();
+
+    /**
+     *  Publishes the first half of the DMA buffer. ISR safe.
+     *
+     *  @param[in]  timestamp     Time in microseconds the last sample was taken
+     *  @return void
+     */
+    void onHalfTransfer( const size_t timestamp );
+
+    /**
+     *  Publishes the second half of the DMA buffer. ISR safe.
+     *
+     *  @param[in]  timestamp     Time in microseconds the last sample was taken
+     *  @return void
+     */
+    void onTransferComplete( const size_t timestamp );
+
+    /**
+     *  Gets the newest unread block. Older unread blocks are already being
+     *  overwritten, so they are skipped and counted as dropped.
+     *
+     *  @param[out] block         Where to write the block
+     *  @return bool              False if nothing is available
+     */
+    bool nextBlock( SampleBlock &block );
+
+    /**
+     *  Finishes with a block from nextBlock(), checking that the hardware
+     *  didn't start overwriting it in the meantime
+     *
+     *  @param[in]  block         Block that was processed
+     *  @return bool              False if the data may have been overwritten, which is counted as dropped
+     */
+    bool releaseBlock( const SampleBlock &block );
+
+    /**
+     *  Number of blocks lost because the consumer fell behind, whether skipped
+     *  by nextBlock() or overwritten before releaseBlock()
+     *  @return size_t
+     */
+    size_t dropped() const;
+
+    /**
+     *  Checks if the stream is configured and accepting events
+     *  @return bool
+     */
+    bool active() const;
+
+  private:
+    StreamInit mConfig;
+    size_t mHalfScans;                        /**< Sequence scans in each half of the buffer */
+    size_t mConsumed;                         /**< Blocks the consumer has moved past. Consumer only. */
+    std::atomic<bool> mActive;                /**< Events are being accepted */
+    std::atomic<size_t> mPublished;           /**< Blocks completed by the hardware */
+    std::atomic<size_t> mDropped;             /**< Blocks lost to the consumer falling behind */
+    std::array<std::atomic<size_t>, 2> mLast; /**< Time of the last scan in each half */
+
+    void publish( const size_t half, const size_t timestamp );
+  };
+}  // namespace Chimera::ADC
+
+#endif /* !CHIMERA_ADC_STREAM_HPP */
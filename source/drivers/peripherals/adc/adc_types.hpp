@@ -13,6 +13,7 @@
 #define CHIMERA_ADC_TYPES_HPP
 
 /* STL Includes */
+#include <array>
 #include <cstdint>
 #include <cstring>
 #include <limits>
@@ -137,6 +138,8 @@ namespace Chimera::ADC
     EOC_SEQUENCE, /**< End of conversion sequence sample */
     ANALOG_WD,    /**< Analog watchdog event */
     OVERRUN,      /**< New sample overwrote unread old sample */
+    DMA_HALF,     /**< Streaming DMA filled the first half of its buffer */
+    DMA_FULL,     /**< Streaming DMA filled the second half of its buffer */
 
     NUM_OPTIONS,
     NONE
@@ -330,6 +333,98 @@ namespace Chimera::ADC
   };
 
 
+  /**
+   *  Configures continuous acquisition of a sequence into a circular DMA buffer.
+   *  The hardware signals DMA_HALF and DMA_FULL as each half of the buffer fills,
+   *  and each half is handed to the consumer as a SampleBlock.
+   */
+  struct StreamInit
+  {
+    SequenceInit sequence; /**< Channels to scan, in order */
+    uint16_t *buffer;      /**< Circular DMA buffer, owned by the user */
+    size_t bufferSize;     /**< Buffer size in samples. Multiple of 2x the sequence length. */
+    size_t scanPeriodUs;   /**< Time between the start of consecutive sequence scans */
+
+    void clear()
+    {
+      sequence.clear();
+      buffer       = nullptr;
+      bufferSize   = 0;
+      scanPeriodUs = 0;
+    }
+  };
+
+
+  /**
+   *  A contiguous run of raw conversions from a stream, interleaved in sequence
+   *  order. Refers directly to the DMA buffer, so it is only valid until the
+   *  other half finishes filling and the hardware wraps back into this one.
+   *  Process or copy it within one half buffer period.
+   */
+  struct SampleBlock
+  {
+    size_t us;              /**< Timestamp of the first scan in microseconds */
+    size_t periodUs;        /**< Time between consecutive scans */
+    const uint16_t *counts; /**< Raw conversion results */
+    size_t numScans;        /**< Number of complete sequence scans */
+    size_t numChannels;     /**< Samples per scan */
+    size_t sequence;        /**< Block counter. Gaps mean blocks were dropped. */
+
+    void clear()
+    {
+      us          = 0;
+      periodUs    = 0;
+      counts      = nullptr;
+      numScans    = 0;
+      numChannels = 0;
+      sequence    = 0;
+    }
+  };
+
+
+  /**
+   *  Converts raw counts into volts for the batch conversion functions:
+   *
+   *    volts = ( ( counts * vref ) / maxCounts ) * gain + offset
+   *
+   *  Gain and offset come from board level calibration of the analog front end.
+   */
+  struct Calibration
+  {
+    float vref;       /**< Reference voltage the converter measures against */
+    float gain;       /**< Multiplicative correction */
+    float offset;     /**< Additive correction in volts */
+    size_t maxCounts; /**< Full scale reading, eg 4095 for 12 bits */
+
+    void clear()
+    {
+      vref      = 3.3f;
+      gain      = 1.0f;
+      offset    = 0.0f;
+      maxCounts = 4095;
+    }
+  };
+
+
+  /**
+   *  Integer form of a Calibration for cores without an FPU. Produced by
+   *  toFixedCalibration().
+   *
+   *    microvolts = ( ( counts * scale ) >> 16 ) + offset
+   */
+  struct FixedCalibration
+  {
+    int64_t scale;  /**< Microvolts per count in Q48.16, wide enough for 6 bit resolution */
+    int32_t offset; /**< Additive correction in microvolts */
+
+    void clear()
+    {
+      scale  = 0;
+      offset = 0;
+    }
+  };
+
+
   /*-------------------------------------------------------------------------------
   Aliases
   -------------------------------------------------------------------------------*/
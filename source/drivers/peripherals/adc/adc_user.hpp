@@ -57,6 +57,10 @@ namespace Chimera::ADC
     bool nextSample( const Channel ch, Sample &sample );
     void onInterrupt( const Interrupt bmSignal, ISRCallback cb );
     float toVoltage( const Sample sample );
+    Chimera::Status_t startStream( const StreamInit &init );
+    void stopStream();
+    bool nextBlock( SampleBlock &block );
+    bool releaseBlock( const SampleBlock &block );
 
     /*-------------------------------------------------
     Interface: Lockable
@@ -0,0 +1,162 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_adc_convert.cpp
+ *
+ *  Description:
+ *    Batch conversion of raw ADC counts into calibrated voltages
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <cmath>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/adc>
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/adc/adc_simd.hpp>
+
+namespace Chimera::ADC
+{
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Converts as many leading elements as the vector unit can handle
+   *
+   *  @return size_t    Number of elements converted
+   */
+  static size_t convertVector( const float scale, const float bias, const uint16_t *const counts, float *const volts,
+                               const size_t length )
+  {
+    size_t idx = 0;
+
+#if defined( CHIMERA_ADC_SSE2 )
+    const __m128 vScale = _mm_set1_ps( scale );
+    const __m128 vBias  = _mm_set1_ps( bias );
+    const __m128i zero  = _mm_setzero_si128();
+
+    for ( ; ( idx + 8 ) <= length; idx += 8 )
+    {
+      const __m128i raw = _mm_loadu_si128( reinterpret_cast<const __m128i *>( counts + idx ) );
+      const __m128 lo   = _mm_cvtepi32_ps( _mm_unpacklo_epi16( raw, zero ) );
+      const __m128 hi   = _mm_cvtepi32_ps( _mm_unpackhi_epi16( raw, zero ) );
+
+      _mm_storeu_ps( volts + idx, _mm_add_ps( _mm_mul_ps( lo, vScale ), vBias ) );
+      _mm_storeu_ps( volts + idx + 4, _mm_add_ps( _mm_mul_ps( hi, vScale ), vBias ) );
+    }
+#elif defined( CHIMERA_ADC_NEON )
+    const float32x4_t vBias = vdupq_n_f32( bias );
+
+    for ( ; ( idx + 8 ) <= length; idx += 8 )
+    {
+      const uint16x8_t raw = vld1q_u16( counts + idx );
+      const float32x4_t lo = vcvtq_f32_u32( vmovl_u16( vget_low_u16( raw ) ) );
+      const float32x4_t hi = vcvtq_f32_u32( vmovl_u16( vget_high_u16( raw ) ) );
+
+      vst1q_f32( volts + idx, vmlaq_n_f32( vBias, lo, scale ) );
+      vst1q_f32( volts + idx + 4, vmlaq_n_f32( vBias, hi, scale ) );
+    }
+#else
+    ( void )scale;
+    ( void )bias;
+    ( void )counts;
+    ( void )volts;
+    ( void )length;
+#endif
+
+    return idx;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  size_t fullScaleCounts( const Resolution resolution )
+  {
+    switch ( resolution )
+    {
+      case Resolution::BIT_12:
+        return 4095;
+
+      case Resolution::BIT_10:
+        return 1023;
+
+      case Resolution::BIT_8:
+        return 255;
+
+      case Resolution::BIT_6:
+        return 63;
+
+      default:
+        return 0;
+    }
+  }
+
+
+  void toVoltage( const Calibration &cal, const uint16_t *const counts, float *const volts, const size_t length )
+  {
+    if ( !counts || !volts || !cal.maxCounts )
+    {
+      return;
+    }
+
+    /*-------------------------------------------------
+    Fold everything into one multiply-add per sample
+    -------------------------------------------------*/
+    const float scale = ( cal.vref * cal.gain ) / static_cast<float>( cal.maxCounts );
+    const float bias  = cal.offset;
+
+    size_t idx = convertVector( scale, bias, counts, volts, length );
+    for ( ; idx < length; idx++ )
+    {
+      volts[ idx ] = ( static_cast<float>( counts[ idx ] ) * scale ) + bias;
+    }
+  }
+
+
+  FixedCalibration toFixedCalibration( const Calibration &cal )
+  {
+    FixedCalibration fixed;
+    fixed.clear();
+
+    if ( cal.maxCounts )
+    {
+      const float uvPerCount = ( cal.vref * cal.gain * 1e6f ) / static_cast<float>( cal.maxCounts );
+      fixed.scale            = static_cast<int64_t>( std::llround( uvPerCount * 65536.0f ) );
+      fixed.offset           = static_cast<int32_t>( std::lround( cal.offset * 1e6f ) );
+    }
+
+    return fixed;
+  }
+
+
+  void toMicrovolts( const FixedCalibration &cal, const uint16_t *const counts, int32_t *const microvolts,
+                     const size_t length )
+  {
+    if ( !counts || !microvolts )
+    {
+      return;
+    }
+
+    /*-------------------------------------------------
+    The product is kept 64 bits wide. At low resolutions
+    the scale alone exceeds 32 bits, eg ~3.4e9 for 6 bit
+    conversions against a 3.3V reference.
+    -------------------------------------------------*/
+    const int64_t scale = cal.scale;
+    const int32_t bias  = cal.offset;
+
+    size_t idx = 0;
+    for ( ; ( idx + 2 ) <= length; idx += 2 )
+    {
+      microvolts[ idx + 0 ] = static_cast<int32_t>( ( counts[ idx + 0 ] * scale ) >> 16 ) + bias;
+      microvolts[ idx + 1 ] = static_cast<int32_t>( ( counts[ idx + 1 ] * scale ) >> 16 ) + bias;
+    }
+
+    if ( idx < length )
+    {
+      microvolts[ idx ] = static_cast<int32_t>( ( counts[ idx ] * scale ) >> 16 ) + bias;
+    }
+  }
+}  // namespace Chimera::ADC
@@ -0,0 +1,231 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_adc_filter.cpp
+ *
+ *  Description:
+ *    Vector kernels and non-template stages of the ADC filter pipeline
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <cmath>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/adc>
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/adc/adc_simd.hpp>
+
+namespace Chimera::ADC::Filter
+{
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  float dotProduct( const float *const a, const float *const b, const size_t length )
+  {
+    size_t idx   = 0;
+    float result = 0.0f;
+
+#if defined( CHIMERA_ADC_SSE2 )
+    __m128 acc = _mm_setzero_ps();
+    for ( ; ( idx + 4 ) <= length; idx += 4 )
+    {
+      acc = _mm_add_ps( acc, _mm_mul_ps( _mm_loadu_ps( a + idx ), _mm_loadu_ps( b + idx ) ) );
+    }
+
+    alignas( 16 ) float lanes[ 4 ];
+    _mm_store_ps( lanes, acc );
+    result = ( lanes[ 0 ] + lanes[ 1 ] ) + ( lanes[ 2 ] + lanes[ 3 ] );
+#elif defined( CHIMERA_ADC_NEON )
+    float32x4_t acc = vdupq_n_f32( 0.0f );
+    for ( ; ( idx + 4 ) <= length; idx += 4 )
+    {
+      acc = vmlaq_f32( acc, vld1q_f32( a + idx ), vld1q_f32( b + idx ) );
+    }
+
+    const float32x2_t pair = vadd_f32( vget_low_f32( acc ), vget_high_f32( acc ) );
+    result                 = vget_lane_f32( pair, 0 ) + vget_lane_f32( pair, 1 );
+#endif
+
+    for ( ; idx < length; idx++ )
+    {
+      result += a[ idx ] * b[ idx ];
+    }
+
+    return result;
+  }
+
+
+  void accumulate( const float *const data, const size_t length, float &min, float &max, float &sum, float &sumSq )
+  {
+    size_t idx = 0;
+
+#if defined( CHIMERA_ADC_SSE2 )
+    if ( length >= 4 )
+    {
+      __m128 vMin = _mm_set1_ps( min );
+      __m128 vMax = _mm_set1_ps( max );
+      __m128 vSum = _mm_setzero_ps();
+      __m128 vSq  = _mm_setzero_ps();
+
+      for ( ; ( idx + 4 ) <= length; idx += 4 )
+      {
+        const __m128 x = _mm_loadu_ps( data + idx );
+        vMin           = _mm_min_ps( vMin, x );
+        vMax           = _mm_max_ps( vMax, x );
+        vSum           = _mm_add_ps( vSum, x );
+        vSq            = _mm_add_ps( vSq, _mm_mul_ps( x, x ) );
+      }
+
+      alignas( 16 ) float lanes[ 4 ][ 4 ];
+      _mm_store_ps( lanes[ 0 ], vMin );
+      _mm_store_ps( lanes[ 1 ], vMax );
+      _mm_store_ps( lanes[ 2 ], vSum );
+      _mm_store_ps( lanes[ 3 ], vSq );
+
+      for ( size_t lane = 0; lane < 4; lane++ )
+      {
+        min = ( lanes[ 0 ][ lane ] < min ) ? lanes[ 0 ][ lane ] : min;
+        max = ( lanes[ 1 ][ lane ] > max ) ? lanes[ 1 ][ lane ] : max;
+        sum += lanes[ 2 ][ lane ];
+        sumSq += lanes[ 3 ][ lane ];
+      }
+    }
+#elif defined( CHIMERA_ADC_NEON )
+    if ( length >= 4 )
+    {
+      float32x4_t vMin = vdupq_n_f32( min );
+      float32x4_t vMax = vdupq_n_f32( max );
+      float32x4_t vSum = vdupq_n_f32( 0.0f );
+      float32x4_t vSq  = vdupq_n_f32( 0.0f );
+
+      for ( ; ( idx + 4 ) <= length; idx += 4 )
+      {
+        const float32x4_t x = vld1q_f32( data + idx );
+        vMin                = vminq_f32( vMin, x );
+        vMax                = vmaxq_f32( vMax, x );
+        vSum                = vaddq_f32( vSum, x );
+        vSq                 = vmlaq_f32( vSq, x, x );
+      }
+
+      float lanes[ 4 ][ 4 ];
+      vst1q_f32( lanes[ 0 ], vMin );
+      vst1q_f32( lanes[ 1 ], vMax );
+      vst1q_f32( lanes[ 2 ], vSum );
+      vst1q_f32( lanes[ 3 ], vSq );
+
+      for ( size_t lane = 0; lane < 4; lane++ )
+      {
+        min = ( lanes[ 0 ][ lane ] < min ) ? lanes[ 0 ][ lane ] : min;
+        max = ( lanes[ 1 ][ lane ] > max ) ? lanes[ 1 ][ lane ] : max;
+        sum += lanes[ 2 ][ lane ];
+        sumSq += lanes[ 3 ][ lane ];
+      }
+    }
+#endif
+
+    for ( ; idx < length; idx++ )
+    {
+      const float x = data[ idx ];
+      min           = ( x < min ) ? x : min;
+      max           = ( x > max ) ? x : max;
+      sum += x;
+      sumSq += x * x;
+    }
+  }
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Kahan summation step, carrying the bits that don't fit in the total
+   *
+   *  @param[in,out] total    Running total
+   *  @param[in,out] error    Running compensation term
+   *  @param[in]  value       Value to add
+   *  @return void
+   */
+  static void compensatedAdd( float &total, float &error, const float value )
+  {
+    const float y = value - error;
+    const float t = total + y;
+    error         = ( t - total ) - y;
+    total         = t;
+  }
+
+  /*-------------------------------------------------------------------------------
+  StatisticsStage Implementation
+  -------------------------------------------------------------------------------*/
+  StatisticsStage::StatisticsStage()
+  {
+    reset();
+  }
+
+
+  size_t StatisticsStage::process( float *const data, const size_t length )
+  {
+    if ( !data || !length )
+    {
+      return length;
+    }
+
+    if ( !mCount )
+    {
+      mMin = data[ 0 ];
+      mMax = data[ 0 ];
+    }
+
+    /*-------------------------------------------------
+    Sum in short single precision chunks so the rounding
+    error of each stays small, then fold them into the
+    compensated totals
+    -------------------------------------------------*/
+    constexpr size_t CHUNK = 256;
+
+    for ( size_t offset = 0; offset < length; offset += CHUNK )
+    {
+      const size_t count = ( ( length - offset ) < CHUNK ) ? ( length - offset ) : CHUNK;
+      float sum          = 0.0f;
+      float sumSq        = 0.0f;
+
+      accumulate( data + offset, count, mMin, mMax, sum, sumSq );
+      compensatedAdd( mSum, mSumErr, sum );
+      compensatedAdd( mSumSq, mSumSqErr, sumSq );
+    }
+
+    mCount += length;
+
+    return length;
+  }
+
+
+  void StatisticsStage::reset()
+  {
+    mMin      = 0.0f;
+    mMax      = 0.0f;
+    mSum      = 0.0f;
+    mSumErr   = 0.0f;
+    mSumSq    = 0.0f;
+    mSumSqErr = 0.0f;
+    mCount    = 0;
+  }
+
+
+  Statistics StatisticsStage::statistics() const
+  {
+    Statistics stats;
+    stats.clear();
+
+    if ( mCount )
+    {
+      stats.min   = mMin;
+      stats.max   = mMax;
+      stats.mean  = mSum / static_cast<float>( mCount );
+      stats.rms   = std::sqrt( mSumSq / static_cast<float>( mCount ) );
+      stats.count = mCount;
+    }
+
+    return stats;
+  }
+}  // namespace Chimera::ADC::Filter
@@ -0,0 +1,58 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_adc_packed.cpp
+ *
+ *  Description:
+ *    Helpers for converting between interleaved and packed ADC data
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <cstdint>
+#include <cstring>
+
+/* Chimera Includes */
+#include <Chimera/adc>
+#include <Chimera/common>
+
+namespace Chimera::ADC
+{
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  void copyStrided( uint16_t *const dst, const uint16_t *const src, const size_t stride, const size_t count )
+  {
+    if ( !dst || !src || !count )
+    {
+      return;
+    }
+
+    if ( stride == 1 )
+    {
+      memcpy( dst, src, count * sizeof( uint16_t ) );
+      return;
+    }
+
+    /*-------------------------------------------------
+    Unrolled so the loads can issue back to back
+    -------------------------------------------------*/
+    size_t idx            = 0;
+    const uint16_t *input = src;
+
+    for ( ; ( idx + 4 ) <= count; idx += 4 )
+    {
+      dst[ idx + 0 ] = input[ 0 ];
+      dst[ idx + 1 ] = input[ stride ];
+      dst[ idx + 2 ] = input[ 2 * stride ];
+      dst[ idx + 3 ] = input[ 3 * stride ];
+      input += 4 * stride;
+    }
+
+    for ( ; idx < count; idx++ )
+    {
+      dst[ idx ] = *input;
+      input += stride;
+    }
+  }
+}  // namespace Chimera::ADC
@@ -0,0 +1,172 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_adc_stream.cpp
+ *
+ *  Description:
+ *    Circular DMA stream management shared by ADC backends
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/adc>
+#include <Chimera/common>
+
+namespace Chimera::ADC
+{
+  /*-------------------------------------------------------------------------------
+  StreamController Implementation
+  -------------------------------------------------------------------------------*/
+  StreamController::StreamController() :
+      mHalfScans( 0 ), mConsumed( 0 ), mActive( false ), mPublished( 0 ), mDropped( 0 )
+  {
+    mConfig.clear();
+    mLast[ 0 ] = 0;
+    mLast[ 1 ] = 0;
+  }
+
+
+  StreamController::~StreamController()
+  {
+  }
+
+
+  Chimera::Status_t StreamController::configure( const StreamInit &init )
+  {
+    /*-------------------------------------------------
+    Each half of the buffer must hold whole scans so
+    every block starts on the first channel.
+    -------------------------------------------------*/
+    const size_t numChannels = init.sequence.numChannels;
+
+    if ( !init.buffer || !numChannels || !init.bufferSize || ( init.bufferSize % ( 2 * numChannels ) ) )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    mActive    = false;
+    mConfig    = init;
+    mHalfScans = init.bufferSize / ( 2 * numChannels );
+    mConsumed  = 0;
+    mPublished = 0;
+    mDropped   = 0;
+    mLast[ 0 ] = 0;
+    mLast[ 1 ] = 0;
+    mActive    = true;
+
+    return Chimera::Status::OK;
+  }
+
+
+  void StreamController::reset()
+  {
+    mActive = false;
+  }
+
+
+  void StreamController::onHalfTransfer( const size_t timestamp )
+  {
+    if ( mActive )
+    {
+      publish( 0, timestamp );
+    }
+  }
+
+
+  void StreamController::onTransferComplete( const size_t timestamp )
+  {
+    if ( mActive )
+    {
+      publish( 1, timestamp );
+    }
+  }
+
+
+  bool StreamController::nextBlock( SampleBlock &block )
+  {
+    while ( true )
+    {
+      const size_t published = mPublished.load( std::memory_order_acquire );
+      if ( published == mConsumed )
+      {
+        return false;
+      }
+
+      /*-------------------------------------------------
+      Read the newest block's timestamp, starting over if
+      the ISR completed another half in the meantime. The
+      acquire pairs with publish(): seeing a newer stamp
+      guarantees seeing the count that preceded it.
+      -------------------------------------------------*/
+      const size_t sequence = published - 1;
+      const size_t half     = sequence % 2;
+      const size_t last     = mLast[ half ].load( std::memory_order_acquire );
+
+      if ( mPublished.load( std::memory_order_acquire ) != published )
+      {
+        continue;
+      }
+
+      mDropped += sequence - mConsumed;
+      mConsumed = published;
+
+      block.periodUs    = mConfig.scanPeriodUs;
+      block.us          = last - ( ( mHalfScans - 1 ) * block.periodUs );
+      block.counts      = mConfig.buffer + ( half * ( mConfig.bufferSize / 2 ) );
+      block.numScans    = mHalfScans;
+      block.numChannels = mConfig.sequence.numChannels;
+      block.sequence    = sequence;
+
+      return true;
+    }
+  }
+
+
+  bool StreamController::releaseBlock( const SampleBlock &block )
+  {
+    /*-------------------------------------------------
+    Once the next block completes, the hardware is
+    writing into this block's half again
+    -------------------------------------------------*/
+    if ( mPublished.load( std::memory_order_acquire ) > ( block.sequence + 1 ) )
+    {
+      mDropped++;
+      return false;
+    }
+
+    return true;
+  }
+
+
+  size_t StreamController::dropped() const
+  {
+    return mDropped;
+  }
+
+
+  bool StreamController::active() const
+  {
+    return mActive;
+  }
+
+
+  void StreamController::publish( const size_t half, const size_t timestamp )
+  {
+    /*-------------------------------------------------
+    Blocks alternate halves. If the event for one half
+    went missing, skip its sequence number so the gap
+    shows up as a drop.
+    -------------------------------------------------*/
+    size_t sequence = mPublished.load( std::memory_order_relaxed );
+    if ( ( sequence % 2 ) != half )
+    {
+      sequence++;
+    }
+
+    mLast[ half ].store( timestamp, std::memory_order_release );
+    mPublished.store( sequence + 1, std::memory_order_release );
+  }
+}  // namespace Chimera::ADC
@@ -0,0 +1,148 @@
+/********************************************************************************
+ *  File Name:
+ *    adc_sim.hpp
+ *
+ *  Description:
+ *    Host simulation backend for the Chimera ADC driver. Conversions come from
+ *    programmable per-channel waveform generators rather than hardware, which
+ *    allows the full acquisition path to be exercised and load tested on a PC.
+ *
+ *    Link chimera_peripheral_adc_sim in place of a hardware backend. Only
+ *    available when building with native threads.
+ *
+ *    A Driver binds to its simulated peripheral when open() succeeds, using
+ *    the peripheral named in the config, so drivers from getDriver() and ones
+ *    constructed directly behave the same. Until then every call returns
+ *    NOT_READY, or false/VOLTAGE_OOR/nothing where there is no status. That
+ *    includes the Lockable methods, so open a driver before locking it.
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_ADC_SIM_HPP
+#define CHIMERA_ADC_SIM_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/adc/adc_types.hpp>
+
+/*-------------------------------------------------------------------------------
+Literals
+-------------------------------------------------------------------------------*/
+/**
+ *  Samples each channel can buffer for nextSample() in INTERRUPT mode before
+ *  an OVERRUN is signaled. Must be a power of two.
+ */
+#ifndef CHIMERA_ADC_SIM_QUEUE_SIZE
+#define CHIMERA_ADC_SIM_QUEUE_SIZE ( 64 )
+#endif
+
+namespace Chimera::ADC::Sim
+{
+  /*-------------------------------------------------------------------------------
+  Enumerations
+  -------------------------------------------------------------------------------*/
+  enum class Waveform : uint8_t
+  {
+    CONSTANT, /**< Fixed voltage of offset */
+    SINE,     /**< offset + amplitude * sin( 2pi * frequency * t + phase ) */
+    NOISE,    /**< Gaussian noise around offset with amplitude as the std deviation */
+    STEP,     /**< offset until stepUs after the simulation starts, then stepValue */
+    FILE,     /**< Raw counts replayed in order from a text file, looping at the end */
+
+    NUM_OPTIONS,
+    UNKNOWN
+  };
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Describes the signal seen by one simulated channel. Voltages are converted
+   *  to counts using the configured reference and resolution, clamped to the
+   *  converter range.
+   */
+  struct Generator
+  {
+    Waveform type;    /**< Signal shape */
+    float offset;     /**< DC level in volts */
+    float amplitude;  /**< Peak amplitude or noise std deviation in volts */
+    float frequency;  /**< Sine frequency in Hz */
+    float phase;      /**< Sine phase in radians */
+    size_t stepUs;    /**< Time of the step edge, relative to the simulation epoch */
+    float stepValue;  /**< Voltage after the step edge */
+    uint32_t seed;    /**< Noise generator seed, for repeatable runs */
+    const char *file; /**< Path to whitespace separated counts for FILE playback */
+
+    void clear()
+    {
+      type      = Waveform::CONSTANT;
+      offset    = 0.0f;
+      amplitude = 0.0f;
+      frequency = 0.0f;
+      phase     = 0.0f;
+      stepUs    = 0;
+      stepValue = 0.0f;
+      seed      = 0;
+      file      = nullptr;
+    }
+  };
+
+
+  /**
+   *  Behavior of a simulated peripheral
+   */
+  struct SimConfig
+  {
+    size_t sampleRate; /**< Sequence scans per second, used when a stream doesn't specify its own */
+    bool realTime;     /**< Pace conversions to the wall clock. If false, run as fast as possible. */
+    float vref;        /**< Reference voltage in volts */
+
+    void clear()
+    {
+      sampleRate = 1000;
+      realTime   = true;
+      vref       = 3.3f;
+    }
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Sets the behavior of a simulated peripheral. Takes effect the next time
+   *  the peripheral is opened or a sequence or stream is started.
+   *
+   *  @param[in]  periph        Peripheral to configure
+   *  @param[in]  cfg           Simulation settings
+   *  @return Chimera::Status_t
+   */
+  Chimera::Status_t configure( const Peripheral periph, const SimConfig &cfg );
+
+  /**
+   *  Assigns a signal generator to a channel. May be called while the
+   *  simulation is running. FILE generators are loaded immediately.
+   *
+   *  @param[in]  periph        Peripheral owning the channel
+   *  @param[in]  ch            Channel to drive
+   *  @param[in]  gen           Signal description
+   *  @return Chimera::Status_t NOT_FOUND if a playback file can't be read
+   */
+  Chimera::Status_t setGenerator( const Peripheral periph, const Channel ch, const Generator &gen );
+
+  /**
+   *  Total conversions produced by a peripheral since it was opened. Useful
+   *  for measuring throughput of the acquisition path.
+   *
+   *  @param[in]  periph        Peripheral to query
+   *  @return size_t
+   */
+  size_t conversions( const Peripheral periph );
+}  // namespace Chimera::ADC::Sim
+
+#endif /* !CHIMERA_ADC_SIM_HPP */
@@ -0,0 +1,847 @@
+/********************************************************************************
+ *  File Name:
+ *    adc_sim_driver.cpp
+ *
+ *  Description:
+ *    Host simulation backend for the Chimera ADC driver
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+/* Chimera Includes */
+#include <Chimera/adc>
+#include <Chimera/common>
+#include <Chimera/container>
+#include <Chimera/thread>
+#include <Chimera/source/drivers/peripherals/adc/sim/adc_sim.hpp>
+
+#if defined( USING_NATIVE_THREADS )
+
+namespace Chimera::ADC::Sim
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t NUM_PERIPHS    = EnumValue( Peripheral::NUM_OPTIONS );
+  static constexpr size_t NUM_CHANNELS   = EnumValue( Channel::NUM_OPTIONS );
+  static constexpr size_t FREE_RUN_BATCH = 64; /**< Scans produced per pass when not paced */
+  static constexpr double TWO_PI         = 6.283185307179586;
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  One simulated ADC peripheral. A worker thread stands in for the conversion
+   *  hardware in INTERRUPT and DMA modes, and invokes the user callbacks from
+   *  that thread as if it were the ISR.
+   */
+  class SimADC
+  {
+  public:
+    Chimera::Thread::RecursiveTimedMutex mMutex;
+
+    SimADC() : mOpen( false ), mMaxCounts( 4095 ), mEpoch( 0 ), mSeqLength( 0 ), mConversions( 0 ), mRunning( false )
+    {
+      mSim.clear();
+      mActive.clear();
+      mConfig.clear();
+      mStreamCfg.clear();
+      mSeqChannels.fill( Channel::UNKNOWN );
+      mSeqMode = SamplingMode::ONE_SHOT;
+
+      for ( auto &state : mChannels )
+      {
+        state.gen.clear();
+        state.playbackIdx = 0;
+      }
+    }
+
+    ~SimADC()
+    {
+      stopWorker();
+    }
+
+    /*-------------------------------------------------
+    Simulation Control
+    -------------------------------------------------*/
+    Chimera::Status_t configure( const SimConfig &cfg )
+    {
+      if ( !cfg.sampleRate || ( cfg.vref <= 0.0f ) )
+      {
+        return Chimera::Status::INVAL_FUNC_PARAM;
+      }
+
+      std::lock_guard<std::mutex> lck( mGenLock );
+      mSim = cfg;
+      return Chimera::Status::OK;
+    }
+
+
+    Chimera::Status_t setGenerator( const Channel ch, const Generator &gen )
+    {
+      const size_t idx = EnumValue( ch );
+      if ( idx >= NUM_CHANNELS )
+      {
+        return Chimera::Status::INVAL_FUNC_PARAM;
+      }
+
+      /*-------------------------------------------------
+      Load playback data before taking the lock so a slow
+      disk doesn't stall the conversion thread.
+      -------------------------------------------------*/
+      std::vector<uint16_t> playback;
+      if ( gen.type == Waveform::FILE )
+      {
+        std::ifstream input( gen.file ? gen.file : "" );
+        unsigned long counts = 0;
+
+        while ( input >> counts )
+        {
+          playback.push_back( static_cast<uint16_t>( counts ) );
+        }
+
+        if ( playback.empty() )
+        {
+          return Chimera::Status::NOT_FOUND;
+        }
+      }
+
+      std::lock_guard<std::mutex> lck( mGenLock );
+      auto &state       = mChannels[ idx ];
+      state.gen         = gen;
+      state.rng.seed( gen.seed );
+      state.normal.reset();
+      state.playback    = std::move( playback );
+      state.playbackIdx = 0;
+
+      return Chimera::Status::OK;
+    }
+
+
+    size_t conversions() const
+    {
+      return mConversions.load( std::memory_order_relaxed );
+    }
+
+    /*-------------------------------------------------
+    Driver Interface
+    -------------------------------------------------*/
+    Chimera::Status_t open( const DriverConfig &init )
+    {
+      stopWorker();
+      applySettings();
+
+      const size_t maxCounts = fullScaleCounts( init.resolution );
+
+      mConfig    = init;
+      mMaxCounts = maxCounts ? maxCounts : 4095;
+      mEpoch     = Chimera::micros();
+      mOpen      = true;
+      mConversions.store( 0, std::memory_order_relaxed );
+
+      for ( auto &queue : mQueues )
+      {
+        queue.clear();
+      }
+
+      return Chimera::Status::OK;
+    }
+
+
+    void close()
+    {
+      stopWorker();
+      mStream.reset();
+      mOpen = false;
+    }
+
+
+    Chimera::Status_t setSampleTime( const Channel ch, const size_t cycles )
+    {
+      /*-------------------------------------------------
+      Conversion timing is set by the sample rate instead
+      -------------------------------------------------*/
+      ( void )cycles;
+      return ( EnumValue( ch ) < NUM_CHANNELS ) ? Chimera::Status::OK : Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+
+    Sample sampleChannel( const Channel ch )
+    {
+      Sample sample;
+      sample.us     = Chimera::micros();
+      sample.counts = ( EnumValue( ch ) < NUM_CHANNELS ) ? convert( ch, sample.us ) : 0;
+
+      mConversions.fetch_add( 1, std::memory_order_relaxed );
+      return sample;
+    }
+
+
+    Chimera::Status_t configSequence( const SequenceInit &cfg )
+    {
+      if ( !cfg.channels || !cfg.numChannels || ( cfg.numChannels > cfg.channels->size() ) )
+      {
+        return Chimera::Status::INVAL_FUNC_PARAM;
+      }
+
+      for ( size_t idx = 0; idx < cfg.numChannels; idx++ )
+      {
+        if ( EnumValue( ( *cfg.channels )[ idx ] ) >= NUM_CHANNELS )
+        {
+          return Chimera::Status::INVAL_FUNC_PARAM;
+        }
+      }
+
+      stopWorker();
+      mSeqChannels = *cfg.channels;
+      mSeqLength   = cfg.numChannels;
+      mSeqMode     = cfg.mode;
+
+      return Chimera::Status::OK;
+    }
+
+
+    void startSequence()
+    {
+      if ( !mOpen || !mSeqLength )
+      {
+        return;
+      }
+
+      stopWorker();
+      applySettings();
+
+      /*-------------------------------------------------
+      Without interrupts the user drives every scan, so
+      do the work right here.
+      -------------------------------------------------*/
+      if ( mConfig.transferMode == TransferMode::ONE_SHOT )
+      {
+        runScan( Chimera::micros() );
+        return;
+      }
+
+      startWorker( &SimADC::runSequence );
+    }
+
+
+    void stopSequence()
+    {
+      stopWorker();
+    }
+
+
+    bool nextSample( const Channel ch, Sample &sample )
+    {
+      const size_t idx = EnumValue( ch );
+      return ( idx < NUM_CHANNELS ) ? mQueues[ idx ].pop( sample ) : false;
+    }
+
+
+    void onInterrupt( const Interrupt bmSignal, ISRCallback cb )
+    {
+      const size_t idx = EnumValue( bmSignal );
+      if ( idx < mCallbacks.size() )
+      {
+        std::lock_guard<std::mutex> lck( mGenLock );
+        mCallbacks[ idx ] = cb;
+      }
+    }
+
+
+    float toVoltage( const Sample &sample )
+    {
+      if ( sample.counts > mMaxCounts )
+      {
+        return VOLTAGE_OOR;
+      }
+
+      return ( static_cast<float>( sample.counts ) * mActive.vref ) / static_cast<float>( mMaxCounts );
+    }
+
+
+    Chimera::Status_t startStream( const StreamInit &init )
+    {
+      if ( !mOpen || !init.sequence.channels )
+      {
+        return Chimera::Status::INVAL_FUNC_PARAM;
+      }
+
+      stopWorker();
+      applySettings();
+
+      /*-------------------------------------------------
+      Fall back on the simulated rate if the user didn't
+      pick one, then let the controller validate it all.
+      -------------------------------------------------*/
+      StreamInit cfg = init;
+      if ( !cfg.scanPeriodUs )
+      {
+        cfg.scanPeriodUs = 1000000 / mActive.sampleRate;
+      }
+
+      auto result = mStream.configure( cfg );
+      if ( result != Chimera::Status::OK )
+      {
+        return result;
+      }
+
+      mStreamCfg   = cfg;
+      mSeqChannels = *init.sequence.channels;
+      mSeqLength   = init.sequence.numChannels;
+
+      startWorker( &SimADC::runStream );
+      return Chimera::Status::OK;
+    }
+
+
+    void stopStream()
+    {
+      stopWorker();
+      mStream.reset();
+    }
+
+
+    bool nextBlock( SampleBlock &block )
+    {
+      return mStream.nextBlock( block );
+    }
+
+
+    bool releaseBlock( const SampleBlock &block )
+    {
+      return mStream.releaseBlock( block );
+    }
+
+  private:
+    struct ChannelState
+    {
+      Generator gen;
+      std::mt19937 rng;
+      std::normal_distribution<float> normal;
+      std::vector<uint16_t> playback;
+      size_t playbackIdx;
+    };
+
+    using SampleQueue = Chimera::Container::SPSCQueue<Sample, CHIMERA_ADC_SIM_QUEUE_SIZE>;
+
+    DriverConfig mConfig;
+    SimConfig mSim;    /**< Settings from Sim::configure(), guarded by mGenLock */
+    SimConfig mActive; /**< Settings in effect, only changed while the worker is stopped */
+    bool mOpen;
+    size_t mMaxCounts;
+    size_t mEpoch; /**< Time the peripheral was opened, the reference for STEP edges */
+
+    std::mutex mGenLock; /**< Guards generators and callbacks against the worker */
+    std::array<ChannelState, NUM_CHANNELS> mChannels;
+    std::array<SampleQueue, NUM_CHANNELS> mQueues;
+    CallbackArray mCallbacks;
+
+    ChannelList mSeqChannels;
+    size_t mSeqLength;
+    SamplingMode mSeqMode;
+
+    StreamController mStream;
+    StreamInit mStreamCfg;
+
+    std::atomic<size_t> mConversions;
+    std::atomic<bool> mRunning;
+    std::thread mWorker;
+
+
+    uint16_t convert( const Channel ch, const size_t us )
+    {
+      std::lock_guard<std::mutex> lck( mGenLock );
+      auto &state = mChannels[ EnumValue( ch ) ];
+
+      const size_t elapsed = ( us > mEpoch ) ? ( us - mEpoch ) : 0;
+      float volts          = state.gen.offset;
+
+      switch ( state.gen.type )
+      {
+        case Waveform::SINE:
+          volts += state.gen.amplitude *
+                   static_cast<float>( std::sin( ( TWO_PI * state.gen.frequency * static_cast<double>( elapsed ) * 1e-6 ) +
+                                                 state.gen.phase ) );
+          break;
+
+        case Waveform::NOISE:
+          volts += state.gen.amplitude * state.normal( state.rng );
+          break;
+
+        case Waveform::STEP:
+          volts = ( elapsed >= state.gen.stepUs ) ? state.gen.stepValue : state.gen.offset;
+          break;
+
+        case Waveform::FILE:
+        {
+          if ( state.playback.empty() )
+          {
+            return 0;
+          }
+
+          const size_t counts = state.playback[ state.playbackIdx ];
+          state.playbackIdx   = ( state.playbackIdx + 1 ) % state.playback.size();
+          return static_cast<uint16_t>( ( counts < mMaxCounts ) ? counts : mMaxCounts );
+        }
+
+        case Waveform::CONSTANT:
+        default:
+          break;
+      }
+
+      const double scaled = ( ( static_cast<double>( volts ) / mActive.vref ) * mMaxCounts ) + 0.5;
+      if ( scaled <= 0.0 )
+      {
+        return 0;
+      }
+
+      return static_cast<uint16_t>( ( scaled >= mMaxCounts ) ? mMaxCounts : static_cast<size_t>( scaled ) );
+    }
+
+
+    void fire( const Interrupt isr, const Channel ch, const Sample &data )
+    {
+      ISRCallback cb;
+      {
+        std::lock_guard<std::mutex> lck( mGenLock );
+        cb = mCallbacks[ EnumValue( isr ) ];
+      }
+
+      if ( cb )
+      {
+        InterruptDetail detail;
+        detail.isr     = isr;
+        detail.channel = ch;
+        detail.data    = data;
+        cb( detail );
+      }
+    }
+
+
+    void runScan( const size_t us )
+    {
+      Sample sample = { us, 0 };
+      Channel ch    = Channel::UNKNOWN;
+
+      for ( size_t idx = 0; idx < mSeqLength; idx++ )
+      {
+        ch            = mSeqChannels[ idx ];
+        sample.counts = convert( ch, us );
+
+        if ( !mQueues[ EnumValue( ch ) ].push( sample ) )
+        {
+          fire( Interrupt::OVERRUN, ch, sample );
+        }
+
+        fire( Interrupt::EOC_SINGLE, ch, sample );
+      }
+
+      mConversions.fetch_add( mSeqLength, std::memory_order_relaxed );
+      fire( Interrupt::EOC_SEQUENCE, ch, sample );
+    }
+
+
+    /**
+     *  Waits until more scans are due and returns the new total
+     */
+    size_t pace( const size_t produced, const size_t rate, const std::chrono::steady_clock::time_point start )
+    {
+      if ( !mActive.realTime )
+      {
+        std::this_thread::yield();
+        return produced + FREE_RUN_BATCH;
+      }
+
+      using namespace std::chrono;
+      while ( mRunning.load( std::memory_order_relaxed ) )
+      {
+        const auto elapsed = duration_cast<microseconds>( steady_clock::now() - start ).count();
+        const size_t due   = static_cast<size_t>( ( static_cast<uint64_t>( elapsed ) * rate ) / 1000000 );
+
+        if ( due > produced )
+        {
+          return due;
+        }
+
+        std::this_thread::sleep_for( microseconds( 200 ) );
+      }
+
+      return produced;
+    }
+
+
+    void runSequence()
+    {
+      const size_t rate  = mActive.sampleRate;
+      const size_t t0    = Chimera::micros();
+      const auto start   = std::chrono::steady_clock::now();
+      const bool oneScan = ( mSeqMode != SamplingMode::CONTINUOUS );
+
+      size_t scan = 0;
+      while ( mRunning.load( std::memory_order_relaxed ) )
+      {
+        const size_t due = pace( scan, rate, start );
+
+        for ( ; ( scan < due ) && mRunning.load( std::memory_order_relaxed ); scan++ )
+        {
+          runScan( t0 + static_cast<size_t>( ( static_cast<uint64_t>( scan ) * 1000000 ) / rate ) );
+
+          if ( oneScan )
+          {
+            mRunning.store( false, std::memory_order_relaxed );
+          }
+        }
+      }
+    }
+
+
+    void runStream()
+    {
+      const size_t numChannels = mStreamCfg.sequence.numChannels;
+      const size_t totalScans  = mStreamCfg.bufferSize / numChannels;
+      const size_t halfScans   = totalScans / 2;
+      const size_t period      = mStreamCfg.scanPeriodUs;
+      const size_t rate        = period ? ( 1000000 / period ) : mActive.sampleRate;
+      const size_t t0          = Chimera::micros();
+      const auto start         = std::chrono::steady_clock::now();
+      const Sample none        = { 0, 0 };
+
+      size_t scan = 0;
+      while ( mRunning.load( std::memory_order_relaxed ) )
+      {
+        const size_t due = pace( scan, rate, start );
+
+        for ( ; ( scan < due ) && mRunning.load( std::memory_order_relaxed ); scan++ )
+        {
+          const size_t pos = scan % totalScans;
+          const size_t us  = t0 + ( scan * period );
+          uint16_t *dst    = mStreamCfg.buffer + ( pos * numChannels );
+
+          for ( size_t idx = 0; idx < numChannels; idx++ )
+          {
+            dst[ idx ] = convert( mSeqChannels[ idx ], us );
+          }
+
+          mConversions.fetch_add( numChannels, std::memory_order_relaxed );
+
+          /*-------------------------------------------------
+          Mimic the half/full transfer interrupts
+          -------------------------------------------------*/
+          if ( ( pos + 1 ) == halfScans )
+          {
+            mStream.onHalfTransfer( us );
+            fire( Interrupt::DMA_HALF, Channel::UNKNOWN, none );
+          }
+          else if ( ( pos + 1 ) == totalScans )
+          {
+            mStream.onTransferComplete( us );
+            fire( Interrupt::DMA_FULL, Channel::UNKNOWN, none );
+          }
+        }
+      }
+    }
+
+
+    /**
+     *  Puts the latest Sim::configure() settings into effect. The worker
+     *  must be stopped.
+     */
+    void applySettings()
+    {
+      std::lock_guard<std::mutex> lck( mGenLock );
+      mActive = mSim;
+    }
+
+
+    void startWorker( void ( SimADC::*fn )() )
+    {
+      stopWorker();
+      mRunning.store( true, std::memory_order_relaxed );
+      mWorker = std::thread( fn, this );
+    }
+
+
+    void stopWorker()
+    {
+      mRunning.store( false, std::memory_order_relaxed );
+      if ( mWorker.joinable() )
+      {
+        mWorker.join();
+      }
+    }
+  };
+
+  /*-------------------------------------------------------------------------------
+  Static Data
+  -------------------------------------------------------------------------------*/
+  static std::array<SimADC, NUM_PERIPHS> s_adc;
+  static std::array<Driver, NUM_PERIPHS> s_drivers;
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  Chimera::Status_t configure( const Peripheral periph, const SimConfig &cfg )
+  {
+    const size_t idx = EnumValue( periph );
+    return ( idx < NUM_PERIPHS ) ? s_adc[ idx ].configure( cfg ) : Chimera::Status::INVAL_FUNC_PARAM;
+  }
+
+
+  Chimera::Status_t setGenerator( const Peripheral periph, const Channel ch, const Generator &gen )
+  {
+    const size_t idx = EnumValue( periph );
+    return ( idx < NUM_PERIPHS ) ? s_adc[ idx ].setGenerator( ch, gen ) : Chimera::Status::INVAL_FUNC_PARAM;
+  }
+
+
+  size_t conversions( const Peripheral periph )
+  {
+    const size_t idx = EnumValue( periph );
+    return ( idx < NUM_PERIPHS ) ? s_adc[ idx ].conversions() : 0;
+  }
+
+
+  /*-------------------------------------------------------------------------------
+  Backend Functions
+  -------------------------------------------------------------------------------*/
+  static Chimera::Status_t initialize()
+  {
+    return Chimera::Status::OK;
+  }
+
+
+  static Chimera::Status_t reset()
+  {
+    for ( auto &adc : s_adc )
+    {
+      adc.close();
+    }
+
+    return Chimera::Status::OK;
+  }
+
+
+  static Driver_rPtr getDriver( const Peripheral periph )
+  {
+    const size_t idx = EnumValue( periph );
+    return ( idx < NUM_PERIPHS ) ? &s_drivers[ idx ] : nullptr;
+  }
+
+
+  static bool featureSupported( const Peripheral periph, const Feature feature )
+  {
+    return ( EnumValue( periph ) < NUM_PERIPHS ) && ( feature == Feature::REGULAR_SAMPLE_GROUP );
+  }
+}  // namespace Chimera::ADC::Sim
+
+
+namespace Chimera::ADC::Backend
+{
+  Chimera::Status_t registerDriver( Chimera::ADC::Backend::DriverConfig &registry )
+  {
+    registry.isSupported      = true;
+    registry.initialize       = Sim::initialize;
+    registry.reset            = Sim::reset;
+    registry.getDriver        = Sim::getDriver;
+    registry.featureSupported = Sim::featureSupported;
+    return Chimera::Status::OK;
+  }
+}  // namespace Chimera::ADC::Backend
+
+
+namespace Chimera::ADC
+{
+  /*-------------------------------------------------------------------------------
+  Driver Implementation
+  -------------------------------------------------------------------------------*/
+  static inline Sim::SimADC *impl( void *driver )
+  {
+    return reinterpret_cast<Sim::SimADC *>( driver );
+  }
+
+
+  Driver::Driver() : mDriver( nullptr )
+  {
+  }
+
+
+  Driver::~Driver()
+  {
+  }
+
+
+  /*-------------------------------------------------
+  Interface: Hardware
+  -------------------------------------------------*/
+  Chimera::Status_t Driver::open( const DriverConfig &init )
+  {
+    const size_t idx = EnumValue( init.periph );
+    if ( idx >= Sim::NUM_PERIPHS )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    /*-------------------------------------------------
+    Bind to the simulated peripheral named by the config
+    -------------------------------------------------*/
+    const Chimera::Status_t result = Sim::s_adc[ idx ].open( init );
+    if ( result == Chimera::Status::OK )
+    {
+      mDriver = &Sim::s_adc[ idx ];
+    }
+
+    return result;
+  }
+
+
+  void Driver::close()
+  {
+    if ( mDriver )
+    {
+      impl( mDriver )->close();
+    }
+  }
+
+
+  Chimera::Status_t Driver::setSampleTime( const Channel ch, const size_t cycles )
+  {
+    return mDriver ? impl( mDriver )->setSampleTime( ch, cycles ) : Chimera::Status::NOT_READY;
+  }
+
+
+  Sample Driver::sampleChannel( const Channel ch )
+  {
+    return mDriver ? impl( mDriver )->sampleChannel( ch ) : Sample{ 0, 0 };
+  }
+
+
+  Chimera::Status_t Driver::configSequence( const SequenceInit &cfg )
+  {
+    return mDriver ? impl( mDriver )->configSequence( cfg ) : Chimera::Status::NOT_READY;
+  }
+
+
+  void Driver::startSequence()
+  {
+    if ( mDriver )
+    {
+      impl( mDriver )->startSequence();
+    }
+  }
+
+
+  void Driver::stopSequence()
+  {
+    if ( mDriver )
+    {
+      impl( mDriver )->stopSequence();
+    }
+  }
+
+
+  bool Driver::nextSample( const Channel ch, Sample &sample )
+  {
+    return mDriver && impl( mDriver )->nextSample( ch, sample );
+  }
+
+
+  void Driver::onInterrupt( const Interrupt bmSignal, ISRCallback cb )
+  {
+    if ( mDriver )
+    {
+      impl( mDriver )->onInterrupt( bmSignal, cb );
+    }
+  }
+
+
+  float Driver::toVoltage( const Sample sample )
+  {
+    return mDriver ? impl( mDriver )->toVoltage( sample ) : VOLTAGE_OOR;
+  }
+
+
+  Chimera::Status_t Driver::startStream( const StreamInit &init )
+  {
+    return mDriver ? impl( mDriver )->startStream( init ) : Chimera::Status::NOT_READY;
+  }
+
+
+  void Driver::stopStream()
+  {
+    if ( mDriver )
+    {
+      impl( mDriver )->stopStream();
+    }
+  }
+
+
+  bool Driver::nextBlock( SampleBlock &block )
+  {
+    return mDriver && impl( mDriver )->nextBlock( block );
+  }
+
+
+  bool Driver::releaseBlock( const SampleBlock &block )
+  {
+    return mDriver && impl( mDriver )->releaseBlock( block );
+  }
+
+
+  /*-------------------------------------------------
+  Interface: Lockable
+  -------------------------------------------------*/
+  void Driver::lock()
+  {
+    if ( mDriver )
+    {
+      impl( mDriver )->mMutex.lock();
+    }
+  }
+
+
+  void Driver::lockFromISR()
+  {
+    if ( mDriver )
+    {
+      impl( mDriver )->mMutex.lock();
+    }
+  }
+
+
+  bool Driver::try_lock_for( const size_t timeout )
+  {
+    return mDriver && impl( mDriver )->mMutex.try_lock_for( timeout );
+  }
+
+
+  void Driver::unlock()
+  {
+    if ( mDriver )
+    {
+      impl( mDriver )->mMutex.unlock();
+    }
+  }
+
+
+  void Driver::unlockFromISR()
+  {
+    if ( mDriver )
+    {
+      impl( mDriver )->mMutex.unlock();
+    }
+  }
+}  // namespace Chimera::ADC
+
+#endif /* USING_NATIVE_THREADS */
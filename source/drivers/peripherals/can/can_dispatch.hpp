@@ -0,0 +1,250 @@
+/********************************************************************************
+ *  File Name:
+ *    can_dispatch.hpp
+ *
+ *  Description:
+ *    Routes received CAN frames to per-ID callbacks or queues
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CAN_DISPATCH_HPP
+#define CHIMERA_CAN_DISPATCH_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/container/lockfree_queue.hpp>
+#include <Chimera/source/drivers/peripherals/can/can_types.hpp>
+
+/*-------------------------------------------------------------------------------
+Literals
+-------------------------------------------------------------------------------*/
+/**
+ *  Slots in the exact ID routing table. Must be a power of two. The table is
+ *  kept at most 3/4 full, so this allows 96 exact routes by default.
+ */
+#ifndef CHIMERA_CAN_DISPATCH_SLOTS
+#define CHIMERA_CAN_DISPATCH_SLOTS ( 128 )
+#endif
+
+/**
+ *  Number of masked range routes. These are checked linearly after an exact
+ *  lookup misses, so keep this small.
+ */
+#ifndef CHIMERA_CAN_DISPATCH_RANGES
+#define CHIMERA_CAN_DISPATCH_RANGES ( 8 )
+#endif
+
+/**
+ *  Depth of a FrameQueue route target. Must be a power of two.
+ */
+#ifndef CHIMERA_CAN_DISPATCH_QUEUE_DEPTH
+#define CHIMERA_CAN_DISPATCH_QUEUE_DEPTH ( 16 )
+#endif
+
+/**
+ *  Frames pulled from the driver per receiveBurst() call in Dispatcher::process()
+ */
+#ifndef CHIMERA_CAN_DISPATCH_RX_BATCH
+#define CHIMERA_CAN_DISPATCH_RX_BATCH ( 16 )
+#endif
+
+namespace Chimera::CAN
+{
+  /*-------------------------------------------------------------------------------
+  Aliases
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Queue a route can feed frames into. The dispatching context is the
+   *  producer and an application thread the consumer.
+   */
+  using FrameQueue = Chimera::Container::SPSCQueue<BasicFrame, CHIMERA_CAN_DISPATCH_QUEUE_DEPTH>;
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct RouteStats
+  {
+    size_t frames;  /**< Frames that matched the route */
+    size_t dropped; /**< Matched frames lost because the route's queue was full */
+
+    void clear()
+    {
+      frames  = 0;
+      dropped = 0;
+    }
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Routes frames by identifier. Exact IDs resolve through an open
+   *  addressing hash table in constant time. Masked ranges are tried next, in
+   *  the order they were added, and anything left over goes to the default
+   *  route if one is set.
+   *
+   *  Each route delivers to either a callback, invoked in the dispatching
+   *  context, or a FrameQueue an application thread drains. Every route
+   *  counts the frames it matched.
+   *
+   *  Routes may only be changed while nothing is dispatching. Counters are
+   *  written only by the dispatching context.
+   */
+  class Dispatcher
+  {
+  public:
+    Dispatcher();
+    ~Dispatcher();
+
+    /**
+     *  Removes every route and zeroes the counters
+     *  @return void
+     */
+    void clear();
+
+    /**
+     *  Routes one identifier to a callback, replacing any existing route for it
+     *
+     *  @param[in]  id            Identifier to match
+     *  @param[in]  mode          Standard or extended identifier
+     *  @param[in]  callback      Function to invoke with matching frames
+     *  @return Chimera::Status_t FULL if the table has no room
+     */
+    Chimera::Status_t route( const Identifier_t id, const IdType mode, FrameCallback_t callback );
+
+    /**
+     *  Routes one identifier to a queue, replacing any existing route for it
+     *
+     *  @param[in]  id            Identifier to match
+     *  @param[in]  mode          Standard or extended identifier
+     *  @param[in]  queue         Queue to push matching frames into
+     *  @return Chimera::Status_t FULL if the table has no room
+     */
+    Chimera::Status_t route( const Identifier_t id, const IdType mode, FrameQueue &queue );
+
+    /**
+     *  Routes every identifier where ( id & mask ) == ( filter.id & mask )
+     *
+     *  @param[in]  range         Identifiers to match
+     *  @param[in]  callback      Function to invoke with matching frames
+     *  @return Chimera::Status_t FULL if CHIMERA_CAN_DISPATCH_RANGES are in use
+     */
+    Chimera::Status_t route( const Filter &range, FrameCallback_t callback );
+    Chimera::Status_t route( const Filter &range, FrameQueue &queue );
+
+    /**
+     *  Removes the exact route for an identifier
+     *
+     *  @param[in]  id            Identifier to stop routing
+     *  @param[in]  mode          Standard or extended identifier
+     *  @return Chimera::Status_t NOT_FOUND if no route existed
+     */
+    Chimera::Status_t remove( const Identifier_t id, const IdType mode );
+
+    /**
+     *  Sets where frames no route matches are sent. Pass nullptr to drop them.
+     *
+     *  @param[in]  callback      Function to invoke with unmatched frames
+     *  @return void
+     */
+    void setDefault( FrameCallback_t callback );
+
+    /**
+     *  Routes a single frame. Safe to call from a backend's RX path.
+     *
+     *  @param[in]  frame         Received frame
+     *  @return bool              True if a route other than the default matched
+     */
+    bool dispatch( const BasicFrame &frame );
+
+    /**
+     *  Routes a batch of frames
+     *
+     *  @param[in]  frames        Received frames
+     *  @param[in]  count         Number of frames
+     *  @return size_t            Number of frames a route other than the default matched
+     */
+    size_t dispatch( const BasicFrame *const frames, const size_t count );
+
+    /**
+     *  Drains a driver's RX buffer and routes everything in it
+     *
+     *  @param[in]  driver        Opened driver to pull frames from
+     *  @return size_t            Number of frames pulled
+     */
+    size_t process( Driver_rPtr driver );
+
+    /**
+     *  Counters for an exact route
+     *
+     *  @param[in]  id            Identifier of the route
+     *  @param[in]  mode          Standard or extended identifier
+     *  @param[out] stats         Receives the counters
+     *  @return bool              False if there is no route for the identifier
+     */
+    bool stats( const Identifier_t id, const IdType mode, RouteStats &stats ) const;
+
+    /**
+     *  Counters for a range route, indexed in the order ranges were added
+     *
+     *  @param[in]  index         Range index
+     *  @param[out] stats         Receives the counters
+     *  @return bool              False if the index isn't in use
+     */
+    bool rangeStats( const size_t index, RouteStats &stats ) const;
+
+    /**
+     *  Number of frames no route matched
+     *  @return size_t
+     */
+    size_t unmatched() const;
+
+  private:
+    static constexpr size_t SLOT_MASK  = CHIMERA_CAN_DISPATCH_SLOTS - 1;
+    static constexpr size_t SLOT_LIMIT = ( CHIMERA_CAN_DISPATCH_SLOTS * 3 ) / 4;
+    static constexpr uint32_t KEY_FREE = 0xFFFFFFFF;
+
+    static_assert( ( CHIMERA_CAN_DISPATCH_SLOTS & SLOT_MASK ) == 0 );
+
+    struct Target
+    {
+      FrameCallback_t callback;
+      FrameQueue *queue;
+      RouteStats stats;
+    };
+
+    struct Entry
+    {
+      uint32_t key;
+      Target target;
+    };
+
+    struct Range
+    {
+      Filter filter;
+      Target target;
+    };
+
+    std::array<Entry, CHIMERA_CAN_DISPATCH_SLOTS> mTable;
+    size_t mNumEntries;
+    std::array<Range, CHIMERA_CAN_DISPATCH_RANGES> mRanges;
+    size_t mNumRanges;
+    FrameCallback_t mDefault;
+    size_t mUnmatched;
+    std::array<BasicFrame, CHIMERA_CAN_DISPATCH_RX_BATCH> mBatch;
+
+    Chimera::Status_t insert( const Identifier_t id, const IdType mode, const Target &target );
+    Chimera::Status_t insert( const Filter &range, const Target &target );
+    size_t findSlot( const uint32_t key ) const;
+    void deliver( Target &target, const BasicFrame &frame );
+  };
+}  // namespace Chimera::CAN
+
+#endif /* !CHIMERA_CAN_DISPATCH_HPP */
@@ -0,0 +1,152 @@
+/********************************************************************************
+ *  File Name:
+ *    can_filter.hpp
+ *
+ *  Description:
+ *    Software acceptance filtering for CAN identifiers. Intended to sit behind
+ *    the hardware filter banks when an application needs to accept more IDs
+ *    than the hardware can hold.
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CAN_FILTER_HPP
+#define CHIMERA_CAN_FILTER_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/can/can_types.hpp>
+
+/*-------------------------------------------------------------------------------
+Literals
+-------------------------------------------------------------------------------*/
+/**
+ *  Slots in the extended ID hash set. Must be a power of two. The set is kept
+ *  at most 3/4 full, so this allows 384 exact extended IDs by default.
+ */
+#ifndef CHIMERA_CAN_SW_FILTER_EXT_SLOTS
+#define CHIMERA_CAN_SW_FILTER_EXT_SLOTS ( 512 )
+#endif
+
+/**
+ *  Number of masked extended ID filters. These are checked linearly, so keep
+ *  this small. Masked standard ID filters have no limit.
+ */
+#ifndef CHIMERA_CAN_SW_FILTER_EXT_MASKS
+#define CHIMERA_CAN_SW_FILTER_EXT_MASKS ( 8 )
+#endif
+
+namespace Chimera::CAN
+{
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Whitelist of CAN identifiers with constant time lookup. A frame passes if
+   *  ( frame.id & mask ) == ( filter.id & mask ) for any added filter.
+   *
+   *  Standard IDs live in a 2048 bit map, with masked standard filters expanded
+   *  into the map when added. Exact extended IDs go into an open addressing
+   *  hash set, and masked extended filters into a short list.
+   *
+   *  Until a filter is added, every frame passes. Not thread safe. Configure
+   *  the filter before enabling reception or while holding the driver lock.
+   */
+  class SoftwareFilter
+  {
+  public:
+    SoftwareFilter();
+    ~SoftwareFilter();
+
+    /**
+     *  Removes all filters, returning to the accept everything state
+     *  @return void
+     */
+    void clear();
+
+    /**
+     *  Adds a single filter
+     *
+     *  @param[in]  filter        Filter to add
+     *  @return Chimera::Status_t FULL if the extended storage is exhausted
+     */
+    Chimera::Status_t add( const Filter &filter );
+
+    /**
+     *  Replaces the current filters with a list, matching the semantics of
+     *  HWInterface::filter()
+     *
+     *  @param[in]  list          Filter list
+     *  @param[in]  size          Number of filters in the list
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t configure( const Filter *const list, const size_t size );
+
+    /**
+     *  Checks if an identifier passes the filter
+     *
+     *  @param[in]  id            Identifier to check
+     *  @param[in]  mode          Standard or extended identifier
+     *  @return bool
+     */
+    bool accept( const Identifier_t id, const IdType mode ) const;
+
+    /**
+     *  Checks if a frame passes the filter
+     *
+     *  @param[in]  frame         Frame to check
+     *  @return bool
+     */
+    bool accept( const BasicFrame &frame ) const;
+
+    /**
+     *  Checks if an FD frame passes the filter
+     *
+     *  @param[in]  frame         Frame to check
+     *  @return bool
+     */
+    bool accept( const FDFrame &frame ) const;
+
+    /**
+     *  Removes rejected frames from a batch, preserving the order of the rest.
+     *  Backends call this on frames pulled from hardware before pushing them
+     *  into the user RX buffer.
+     *
+     *  @param[in,out] frames     Batch of received frames
+     *  @param[in]  count         Number of frames in the batch
+     *  @return size_t            Number of frames that passed, now at the front
+     */
+    size_t apply( BasicFrame *const frames, const size_t count ) const;
+
+    /**
+     *  Checks if any filters are installed
+     *  @return bool
+     */
+    bool active() const;
+
+  private:
+    static constexpr size_t STD_WORDS  = ( ID_MASK_11_BIT + 1 ) / 32;
+    static constexpr size_t EXT_MASK   = CHIMERA_CAN_SW_FILTER_EXT_SLOTS - 1;
+    static constexpr size_t EXT_LIMIT  = ( CHIMERA_CAN_SW_FILTER_EXT_SLOTS * 3 ) / 4;
+    static constexpr uint32_t EXT_FREE = 0xFFFFFFFF;
+
+    static_assert( ( CHIMERA_CAN_SW_FILTER_EXT_SLOTS & EXT_MASK ) == 0 );
+
+    bool mActive;
+    std::array<uint32_t, STD_WORDS> mStandard;
+    std::array<uint32_t, CHIMERA_CAN_SW_FILTER_EXT_SLOTS> mExtended;
+    size_t mNumExtended;
+    std::array<Filter, CHIMERA_CAN_SW_FILTER_EXT_MASKS> mExtMasks;
+    size_t mNumExtMasks;
+
+    bool findExtended( const uint32_t id ) const;
+  };
+}  // namespace Chimera::CAN
+
+#endif /* !CHIMERA_CAN_FILTER_HPP */
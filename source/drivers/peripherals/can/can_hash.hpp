@@ -0,0 +1,100 @@
+/********************************************************************************
+ *  File Name:
+ *    can_hash.hpp
+ *
+ *  Description:
+ *    Open addressed hash table helpers shared by the CAN dispatcher and the
+ *    software acceptance filter. Internal to the CAN driver sources.
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CAN_HASH_HPP
+#define CHIMERA_CAN_HASH_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+namespace Chimera::CAN::Internal
+{
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Fibonacci hash of a 32-bit key into a slot index
+   *
+   *  @param[in]  key         Key to hash
+   *  @param[in]  mask        Table size minus one, table size being a power of two
+   *  @return size_t
+   */
+  static inline size_t hashSlot( const uint32_t key, const size_t mask )
+  {
+    return static_cast<size_t>( ( key * 0x9E3779B1u ) >> 16 ) & mask;
+  }
+
+
+  /**
+   *  Linear probe for a key. The table must never be allowed to fill, so a
+   *  free slot always terminates the probe.
+   *
+   *  @tparam Table           std::array of slots, sized to a power of two
+   *  @tparam KeyOf           Callable returning the key stored in a slot
+   *  @param[in]  table       Table to search
+   *  @param[in]  key         Key to find
+   *  @param[in]  freeKey     Key value marking an unused slot
+   *  @param[in]  keyOf       Key accessor
+   *  @return size_t          Index of the key, or table.size() if not present
+   */
+  template<typename Table, typename KeyOf>
+  size_t findSlot( const Table &table, const uint32_t key, const uint32_t freeKey, KeyOf keyOf )
+  {
+    constexpr size_t mask = std::tuple_size<Table>::value - 1;
+    static_assert( ( std::tuple_size<Table>::value & mask ) == 0, "Table size must be a power of two" );
+
+    size_t slot = hashSlot( key, mask );
+    while ( keyOf( table[ slot ] ) != freeKey )
+    {
+      if ( keyOf( table[ slot ] ) == key )
+      {
+        return slot;
+      }
+
+      slot = ( slot + 1 ) & mask;
+    }
+
+    return table.size();
+  }
+
+
+  /**
+   *  Linear probe for the slot a new key should be stored in. The caller must
+   *  ensure the key isn't already present and that the table has room.
+   *
+   *  @tparam Table           std::array of slots, sized to a power of two
+   *  @tparam KeyOf           Callable returning the key stored in a slot
+   *  @param[in]  table       Table to search
+   *  @param[in]  key         Key about to be inserted
+   *  @param[in]  freeKey     Key value marking an unused slot
+   *  @param[in]  keyOf       Key accessor
+   *  @return size_t          Index of the first free slot in the key's probe run
+   */
+  template<typename Table, typename KeyOf>
+  size_t freeSlot( const Table &table, const uint32_t key, const uint32_t freeKey, KeyOf keyOf )
+  {
+    constexpr size_t mask = std::tuple_size<Table>::value - 1;
+    static_assert( ( std::tuple_size<Table>::value & mask ) == 0, "Table size must be a power of two" );
+
+    size_t slot = hashSlot( key, mask );
+    while ( keyOf( table[ slot ] ) != freeKey )
+    {
+      slot = ( slot + 1 ) & mask;
+    }
+
+    return slot;
+  }
+}  // namespace Chimera::CAN::Internal
+
+#endif /* !CHIMERA_CAN_HASH_HPP */
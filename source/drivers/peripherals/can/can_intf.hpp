@@ -35,6 +35,74 @@ namespace Chimera::CAN
   }  // namespace Backend
 
 
+  namespace Util
+  {
+    /**
+     *  Computes a key that orders frames the way bus arbitration does. The
+     *  frame with the lower key wins. Accounts for standard frames beating
+     *  extended frames with the same base ID, and data beating remote frames.
+     *
+     *  @param[in]  frame       Frame to rank
+     *  @return uint64_t
+     */
+    uint64_t arbitrationKey( const BasicFrame &frame );
+
+    /**
+     *  Counts the bits a frame occupies on the bus, from start of frame through
+     *  the interframe space, including the stuff bits its content requires.
+     *
+     *  @param[in]  frame       Frame to measure
+     *  @return size_t
+     */
+    size_t frameBits( const BasicFrame &frame );
+
+    /**
+     *  Arbitration key for an FD frame, on the same scale as classic frame
+     *  keys. An FD frame gets the key of a classic data frame with the same
+     *  ID. On a tie the classic frame wins, since the bus settles it on the
+     *  dominant r0 bit versus the recessive FDF bit.
+     *
+     *  @param[in]  frame       Frame to rank
+     *  @return uint64_t
+     */
+    uint64_t arbitrationKey( const FDFrame &frame );
+
+    /**
+     *  Counts the bits an FD frame occupies on the bus, split by the rate they
+     *  are sent at. Without bitRateSwitch, add the two for the total.
+     *
+     *  @param[in]  frame         Frame to measure
+     *  @param[out] dataPhaseBits Bits from ESI through the CRC delimiter
+     *  @return size_t            Bits sent at the nominal rate
+     */
+    size_t frameBits( const FDFrame &frame, size_t &dataPhaseBits );
+
+    /**
+     *  Converts an FD DLC code into a payload length
+     *
+     *  @param[in]  dlc         DLC code, 0-15
+     *  @return size_t          Payload length in bytes
+     */
+    size_t fdLength( const uint8_t dlc );
+
+    /**
+     *  Converts a payload length into the smallest FD DLC code that holds it
+     *
+     *  @param[in]  length      Payload length in bytes, up to MAX_FD_PAYLOAD_LENGTH
+     *  @return uint8_t         DLC code
+     */
+    uint8_t fdDLC( const size_t length );
+
+    /**
+     *  Rounds a payload length up to the next length a DLC can encode
+     *
+     *  @param[in]  length      Payload length in bytes, up to MAX_FD_PAYLOAD_LENGTH
+     *  @return size_t
+     */
+    size_t fdPaddedLength( const size_t length );
+  }  // namespace Util
+
+
   /*-------------------------------------------------------------------------------
   Classes
   -------------------------------------------------------------------------------*/
@@ -67,6 +135,14 @@ namespace Chimera::CAN
      */
     virtual CANStatus getStatus() = 0;
 
+    /**
+     *  Zeroes the status counters and high water marks. Buffer levels and
+     *  the hardware error counters are left alone.
+     *
+     *  @return void
+     */
+    virtual void resetStatus() = 0;
+
     /**
      *  Enqueues a frame on the TX FIFO to be sent out on the bus
      *
@@ -86,10 +162,44 @@ namespace Chimera::CAN
      */
     virtual Chimera::Status_t receive( BasicFrame &frame ) = 0;
 
+    /**
+     *  Same as receive(), but also reports when the frame arrived. Timestamps
+     *  are kept alongside the RX buffer rather than in the frame, so frames
+     *  stay small.
+     *
+     *  @param[out] frame       The frame to place the received message into
+     *  @param[out] timestamp   Microseconds when the frame finished arriving
+     *  @return Chimera::Status_t
+     */
+    virtual Chimera::Status_t receive( BasicFrame &frame, uint32_t &timestamp ) = 0;
+
+    /**
+     *  Enqueues as many frames from a batch as the TX FIFO can hold, in order,
+     *  taking the driver lock and kicking the hardware mailboxes only once.
+     *
+     *  @param[in]  frames      Frames to be transmitted
+     *  @param[in]  count       Number of frames in the batch
+     *  @return size_t          Number of frames queued from the front of the batch
+     */
+    virtual size_t sendBurst( const BasicFrame *const frames, const size_t count ) = 0;
+
+    /**
+     *  Drains up to count frames off the RX FIFO in a single locked pass.
+     *  Does not wait for frames to arrive.
+     *
+     *  @param[out] frames      Buffer to place the received messages into
+     *  @param[in]  count       Number of frames the buffer can hold
+     *  @return size_t          Number of frames written to the buffer
+     */
+    virtual size_t receiveBurst( BasicFrame *const frames, const size_t count ) = 0;
+
     /**
      *  Uses the given filter list to selectively decide which messages
      *  will make it into the RX FIFO. This is a whitelisting approach.
      *
+     *  @note If the list exceeds the hardware filter banks, backends should
+     *        open the hardware filters and run a SoftwareFilter on the RX path.
+     *
      *  @param[in]  list        Identifier whitelist
      *  @param[in]  size        Number of filter elements in the list
      *  @return Chimera::Status_t
@@ -111,6 +221,39 @@ namespace Chimera::CAN
      *  @return size_t
      */
     virtual size_t available() = 0;
+
+    /**
+     *  Enqueues an FD frame on the FD TX FIFO
+     *
+     *  @param[in]  frame       The frame to be transmitted
+     *  @return Chimera::Status_t NOT_SUPPORTED if the channel wasn't opened with fdMode
+     */
+    virtual Chimera::Status_t sendFD( const FDFrame &frame ) = 0;
+
+    /**
+     *  Reads a frame off the FD RX FIFO. FD frames pass through the same
+     *  filters as classic frames.
+     *
+     *  @param[out] frame       The frame to place the received message into
+     *  @return Chimera::Status_t EMPTY if no FD frame is waiting
+     */
+    virtual Chimera::Status_t receiveFD( FDFrame &frame ) = 0;
+
+    /**
+     *  Same as receiveFD(), but also reports when the frame arrived
+     *
+     *  @param[out] frame       The frame to place the received message into
+     *  @param[out] timestamp   Microseconds when the frame finished arriving
+     *  @return Chimera::Status_t EMPTY if no FD frame is waiting
+     */
+    virtual Chimera::Status_t receiveFD( FDFrame &frame, uint32_t &timestamp ) = 0;
+
+    /**
+     *  Checks how many FD frames are available for reception
+     *
+     *  @return size_t
+     */
+    virtual size_t availableFD() = 0;
   };
 
 
@@ -0,0 +1,275 @@
+/********************************************************************************
+ *  File Name:
+ *    can_isotp.hpp
+ *
+ *  Description:
+ *    ISO 15765-2 (ISO-TP) transport over Chimera CAN, using normal addressing
+ *    and classic 8 byte frames. Messages are segmented directly out of, and
+ *    reassembled directly into, caller owned buffers.
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CAN_ISOTP_HPP
+#define CHIMERA_CAN_ISOTP_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/can/can_types.hpp>
+
+/*-------------------------------------------------------------------------------
+Literals
+-------------------------------------------------------------------------------*/
+/**
+ *  Number of sessions a single Transport can route frames to
+ */
+#ifndef CHIMERA_CAN_ISOTP_MAX_SESSIONS
+#define CHIMERA_CAN_ISOTP_MAX_SESSIONS ( 8 )
+#endif
+
+/**
+ *  Frames pulled from the driver per receiveBurst() call in Transport::process()
+ */
+#ifndef CHIMERA_CAN_ISOTP_RX_BATCH
+#define CHIMERA_CAN_ISOTP_RX_BATCH ( 16 )
+#endif
+
+namespace Chimera::CAN::ISOTP
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t SF_MAX_LENGTH = 7;          /**< Largest message sent as a single frame */
+  static constexpr size_t FF_MAX_LENGTH = 4095;       /**< Largest length a first frame can encode without the escape */
+  static constexpr size_t MAX_LENGTH    = 0xFFFFFFFF; /**< Largest message with the escaped first frame */
+
+  /*-------------------------------------------------------------------------------
+  Enumerations
+  -------------------------------------------------------------------------------*/
+  enum class State : uint8_t
+  {
+    IDLE,              /**< Nothing in progress */
+    WAIT_FLOW_CONTROL, /**< TX: waiting on the receiver to grant the next block */
+    TRANSFERRING,      /**< Consecutive frames are moving */
+    COMPLETE,          /**< RX: a message is in the buffer waiting to be taken */
+    ERROR,             /**< The last transfer failed, see the result */
+
+    NUM_OPTIONS,
+    UNKNOWN
+  };
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct SessionConfig
+  {
+    Identifier_t txId;   /**< ID this node transmits on */
+    Identifier_t rxId;   /**< ID the peer transmits on */
+    IdType idMode;       /**< Standard or extended IDs */
+    uint8_t blockSize;   /**< Consecutive frames the peer may send per flow control, 0 for unlimited */
+    uint8_t stMin;       /**< Raw STmin the peer must leave between frames: 0-127 ms, or 0xF1-0xF9 for 100-900 us */
+    bool padFrames;      /**< Pad every frame out to 8 bytes */
+    uint8_t padValue;    /**< Byte used for padding */
+    size_t timeout;      /**< N_Bs / N_Cr: ms to wait for a flow control or the next consecutive frame */
+    uint8_t maxWaits;    /**< Flow control WAIT responses tolerated before giving up */
+
+    void clear()
+    {
+      txId      = 0;
+      rxId      = 0;
+      idMode    = IdType::STANDARD;
+      blockSize = 0;
+      stMin     = 0;
+      padFrames = true;
+      padValue  = 0xCC;
+      timeout   = 1000;
+      maxWaits  = 8;
+    }
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  One ISO-TP connection: a TX/RX identifier pair with an independent send
+   *  and receive direction. Nothing blocks. Received frames are fed in with
+   *  handle() and transmission progresses in poll(), either directly or
+   *  through a Transport.
+   *
+   *  Not thread safe. Drive each session from a single thread.
+   */
+  class Session
+  {
+  public:
+    Session();
+    ~Session();
+
+    /**
+     *  Binds the session to a driver and resets both directions
+     *
+     *  @param[in]  driver        Opened CAN driver to transmit on
+     *  @param[in]  cfg           Session settings
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t open( Driver_rPtr driver, const SessionConfig &cfg );
+
+    /**
+     *  Abandons any transfers in progress and unbinds the driver
+     *  @return void
+     */
+    void close();
+
+    /**
+     *  Sets where incoming messages are reassembled. A first frame announcing
+     *  more data than this holds is refused with an overflow flow control.
+     *
+     *  @param[in]  buffer        Reassembly buffer
+     *  @param[in]  size          Size of the buffer in bytes
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t setRxBuffer( uint8_t *const buffer, const size_t size );
+
+    /**
+     *  Starts sending a message. The data is segmented straight out of the
+     *  given buffer, so it must stay valid until txState() leaves
+     *  WAIT_FLOW_CONTROL and TRANSFERRING.
+     *
+     *  @param[in]  data          Message to send
+     *  @param[in]  length        Number of bytes in the message
+     *  @return Chimera::Status_t BUSY if a send is in progress, else the driver result for the first frame
+     */
+    Chimera::Status_t send( const uint8_t *const data, const size_t length );
+
+    /**
+     *  Processes a received frame
+     *
+     *  @param[in]  frame         Frame pulled from the driver
+     *  @return bool              False if the frame isn't addressed to this session
+     */
+    bool handle( const BasicFrame &frame );
+
+    /**
+     *  Sends consecutive frames that are due and checks the timeouts
+     *  @return void
+     */
+    void poll();
+
+    /**
+     *  Takes a completed message, freeing the RX buffer for the next one.
+     *  Until this is called, new messages from the peer are refused.
+     *
+     *  @param[out] length        Size of the message in the RX buffer
+     *  @return bool              True if a message was waiting
+     */
+    bool receive( size_t &length );
+
+    State txState() const;
+    State rxState() const;
+
+    /**
+     *  Outcome of the last transfer in each direction. TIMEOUT if the peer
+     *  went quiet, FULL if a receiver refused the size, FAIL on a protocol
+     *  error such as an out of order consecutive frame.
+     */
+    Chimera::Status_t txResult() const;
+    Chimera::Status_t rxResult() const;
+
+    const SessionConfig &config() const;
+
+  private:
+    Driver_rPtr mDriver;
+    SessionConfig mConfig;
+
+    /*-------------------------------------------------
+    Transmit direction
+    -------------------------------------------------*/
+    State mTxState;
+    Chimera::Status_t mTxResult;
+    const uint8_t *mTxData;
+    size_t mTxLength;
+    size_t mTxOffset;
+    uint8_t mTxSN;
+    uint8_t mTxBlockLeft;  /**< Frames left in the granted block, 0 for no limit */
+    size_t mTxGapUs;       /**< Peer's STmin */
+    size_t mTxNextUs;      /**< Earliest time the next CF may go out */
+    size_t mTxDeadline;    /**< ms by which a flow control must arrive */
+    uint8_t mTxWaits;
+
+    /*-------------------------------------------------
+    Receive direction
+    -------------------------------------------------*/
+    State mRxState;
+    Chimera::Status_t mRxResult;
+    uint8_t *mRxBuffer;
+    size_t mRxSize;
+    size_t mRxLength;
+    size_t mRxOffset;
+    uint8_t mRxSN;
+    uint8_t mRxBlockCount;
+    size_t mRxDeadline;
+    bool mFlowPending; /**< A CTS flow control couldn't be queued and must be retried */
+
+    void onSingleFrame( const BasicFrame &frame );
+    void onFirstFrame( const BasicFrame &frame );
+    void onConsecutiveFrame( const BasicFrame &frame );
+    void onFlowControl( const BasicFrame &frame );
+
+    void pumpConsecutive();
+    bool sendFlowControl( const uint8_t status );
+    void buildFrame( BasicFrame &frame, const size_t length ) const;
+    void finishTx( const Chimera::Status_t result );
+    void finishRx( const Chimera::Status_t result );
+  };
+
+
+  /**
+   *  Drains a driver's RX buffer and routes each frame to the session whose
+   *  rxId matches, then polls every session. Frames no session claims go to
+   *  an optional callback so ISO-TP can share a channel with other traffic.
+   */
+  class Transport
+  {
+  public:
+    Transport();
+    ~Transport();
+
+    /**
+     *  @param[in]  driver        Opened CAN driver to pull frames from
+     *  @param[in]  unhandled     Optional callback for frames no session claims
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t open( Driver_rPtr driver, FrameCallback_t unhandled = nullptr );
+
+    /**
+     *  @param[in]  session       Opened session to route frames to
+     *  @return Chimera::Status_t FULL if CHIMERA_CAN_ISOTP_MAX_SESSIONS are attached
+     */
+    Chimera::Status_t attach( Session &session );
+
+    /**
+     *  @param[in]  session       Session to stop routing frames to
+     *  @return Chimera::Status_t NOT_FOUND if it wasn't attached
+     */
+    Chimera::Status_t detach( Session &session );
+
+    /**
+     *  Runs one pass of frame routing and session polling
+     *  @return size_t            Number of frames pulled from the driver
+     */
+    size_t process();
+
+  private:
+    Driver_rPtr mDriver;
+    FrameCallback_t mUnhandled;
+    std::array<Session *, CHIMERA_CAN_ISOTP_MAX_SESSIONS> mSessions;
+    std::array<BasicFrame, CHIMERA_CAN_ISOTP_RX_BATCH> mBatch;
+  };
+}  // namespace Chimera::CAN::ISOTP
+
+#endif /* !CHIMERA_CAN_ISOTP_HPP */
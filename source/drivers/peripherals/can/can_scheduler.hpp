@@ -0,0 +1,170 @@
+/********************************************************************************
+ *  File Name:
+ *    can_scheduler.hpp
+ *
+ *  Description:
+ *    Priority ordered TX queues for classic and FD CAN frames. Keeps a backlog
+ *    of high ID frames from holding urgent low ID frames out of the hardware
+ *    mailboxes.
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CAN_SCHEDULER_HPP
+#define CHIMERA_CAN_SCHEDULER_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/can/can_types.hpp>
+
+/*-------------------------------------------------------------------------------
+Literals
+-------------------------------------------------------------------------------*/
+/**
+ *  Most frames a TxScheduler or FDTxScheduler can hold. A TX buffer larger than this only has
+ *  its first CHIMERA_CAN_TX_SCHEDULER_DEPTH elements used.
+ */
+#ifndef CHIMERA_CAN_TX_SCHEDULER_DEPTH
+#define CHIMERA_CAN_TX_SCHEDULER_DEPTH ( 32 )
+#endif
+
+namespace Chimera::CAN
+{
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Min-heap of pending TX frames ordered the way bus arbitration orders
+   *  them, see Util::arbitrationKey(). Frames that tie, such as consecutive
+   *  frames with the same ID, come out in the order they were pushed.
+   *
+   *  Frames are stored in the user's HardwareInit::txBuffer (fdTxBuffer for
+   *  FD frames) and stay in the same slot until popped. Only a small index
+   *  heap moves around. Not thread safe, so call from behind the driver lock.
+   *
+   *  Typical backend use:
+   *    - send() pushes, then refills any empty mailboxes by popping
+   *    - if a mailbox holds a frame that top() beats, abort it, requeue()
+   *      the aborted frame and load the mailbox from pop()
+   *
+   *  @tparam T               BasicFrame or FDFrame
+   */
+  template<typename T>
+  class BasicTxScheduler
+  {
+  public:
+    BasicTxScheduler();
+    ~BasicTxScheduler();
+
+    /**
+     *  Uses a buffer as frame storage and empties the queue
+     *
+     *  @param[in]  buffer        Frame storage, typically HardwareInit::txBuffer or fdTxBuffer
+     *  @param[in]  elements      Number of frames the buffer can hold
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t attach( T *const buffer, const size_t elements );
+
+    /**
+     *  Drops all pending frames
+     *  @return void
+     */
+    void clear();
+
+    /**
+     *  Queues a frame behind any pending frames of equal priority
+     *
+     *  @param[in]  frame         Frame to queue
+     *  @param[out] slot          Optional, receives the buffer index holding the frame
+     *  @return Chimera::Status_t FULL if no storage is left
+     */
+    Chimera::Status_t push( const T &frame, size_t *const slot = nullptr );
+
+    /**
+     *  Puts back a frame that was pulled out of a mailbox before it won the
+     *  bus. It goes ahead of pending frames of equal priority, since it was
+     *  queued before them.
+     *
+     *  @param[in]  frame         Frame that was aborted
+     *  @param[out] slot          Optional, receives the buffer index holding the frame
+     *  @return Chimera::Status_t FULL if no storage is left
+     */
+    Chimera::Status_t requeue( const T &frame, size_t *const slot = nullptr );
+
+    /**
+     *  Removes the highest priority frame
+     *
+     *  @param[out] frame         Receives the frame
+     *  @param[out] slot          Optional, receives the buffer index the frame was in
+     *  @return bool              False if the queue was empty
+     */
+    bool pop( T &frame, size_t *const slot = nullptr );
+
+    /**
+     *  Highest priority frame without removing it
+     *  @return const T *         nullptr if the queue is empty
+     */
+    const T *top() const;
+
+    /**
+     *  Checks if the highest pending frame would win arbitration against a
+     *  frame already loaded into a mailbox
+     *
+     *  @param[in]  loaded        Frame sitting in a mailbox
+     *  @return bool
+     */
+    bool preempts( const T &loaded ) const;
+
+    /**
+     *  Picks the mailbox to abort so the highest pending frame can take its
+     *  place. Only pass mailboxes that currently hold a frame.
+     *
+     *  @param[in]  mailboxes     Frames loaded in each mailbox
+     *  @param[in]  count         Number of mailboxes
+     *  @return size_t            Index of the lowest priority mailbox that top() beats, or count if none
+     */
+    size_t preemptSlot( const T *const mailboxes, const size_t count ) const;
+
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+
+  private:
+    struct Entry
+    {
+      uint64_t order; /**< Arbitration key in the upper half, sequence in the lower */
+      uint16_t slot;  /**< Index into mBuffer */
+    };
+
+    static constexpr uint32_t SEQ_START = 0x80000000;
+
+    static_assert( CHIMERA_CAN_TX_SCHEDULER_DEPTH <= 0xFFFF );
+
+    T *mBuffer;
+    size_t mCapacity;
+    size_t mSize;
+    uint32_t mBackSeq;  /**< Next sequence for push(), counts up */
+    uint32_t mFrontSeq; /**< Next sequence for requeue(), counts down */
+    std::array<Entry, CHIMERA_CAN_TX_SCHEDULER_DEPTH> mHeap;
+    std::array<uint16_t, CHIMERA_CAN_TX_SCHEDULER_DEPTH> mFree;
+
+    Chimera::Status_t insert( const T &frame, const uint32_t seq, size_t *const slot );
+    void renumber();
+    void siftUp( size_t idx );
+    void siftDown( size_t idx );
+  };
+
+  /*-------------------------------------------------------------------------------
+  Aliases
+  -------------------------------------------------------------------------------*/
+  using TxScheduler   = BasicTxScheduler<BasicFrame>;
+  using FDTxScheduler = BasicTxScheduler<FDFrame>;
+}  // namespace Chimera::CAN
+
+#endif /* !CHIMERA_CAN_SCHEDULER_HPP */
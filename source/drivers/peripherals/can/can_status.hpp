@@ -0,0 +1,190 @@
+/********************************************************************************
+ *  File Name:
+ *    can_status.hpp
+ *
+ *  Description:
+ *    Bookkeeping behind CANStatus: buffer levels, traffic counters, fault
+ *    confinement counters and a rolling bus load measurement
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CAN_STATUS_HPP
+#define CHIMERA_CAN_STATUS_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/can/can_types.hpp>
+
+/*-------------------------------------------------------------------------------
+Literals
+-------------------------------------------------------------------------------*/
+/**
+ *  Span of the rolling bus load measurement
+ */
+#ifndef CHIMERA_CAN_STATUS_LOAD_WINDOW_MS
+#define CHIMERA_CAN_STATUS_LOAD_WINDOW_MS ( 100 )
+#endif
+
+/**
+ *  Number of buckets the load window is divided into. More buckets make the
+ *  window slide more smoothly at the cost of 8 bytes of RAM each.
+ */
+#ifndef CHIMERA_CAN_STATUS_LOAD_BUCKETS
+#define CHIMERA_CAN_STATUS_LOAD_BUCKETS ( 10 )
+#endif
+
+namespace Chimera::CAN
+{
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Accumulates the data a backend reports through getStatus(). The backend
+   *  calls the event hooks from wherever it learns of the event, usually its
+   *  ISRs, and snapshot() turns the result into a CANStatus.
+   *
+   *  Timestamps are microseconds from whatever clock the backend stamps
+   *  frames with, a hardware timer or Chimera::micros(). Not thread safe, so
+   *  guard it the same way as the RX/TX buffers.
+   *
+   *  Backends that can read TEC/REC from hardware should report them with
+   *  errorCounters(). Otherwise the counters follow the ISO 11898-1 rules
+   *  for the events the backend does report.
+   */
+  class StatusTracker
+  {
+  public:
+    StatusTracker();
+    ~StatusTracker();
+
+    /**
+     *  Clears everything, including buffer capacities and the load history
+     *
+     *  @param[in]  timestamp     Current time, the start of the load window
+     *  @param[in]  baudRate      Nominal bit rate in Hz
+     *  @param[in]  dataBaudRate  CAN FD data phase bit rate in Hz, 0 if unused
+     *  @return void
+     */
+    void reset( const size_t timestamp, const size_t baudRate, const size_t dataBaudRate = 0 );
+
+    /**
+     *  Zeroes the traffic counters and high water marks, see
+     *  HWInterface::resetStatus()
+     *
+     *  @return void
+     */
+    void clearCounters();
+
+    /**
+     *  Sets how many frames a buffer holds
+     *
+     *  @param[in]  type          Which direction
+     *  @param[in]  elements      Capacity in frames
+     *  @param[in]  fd            Selects the FD buffer for that direction
+     *  @return void
+     */
+    void capacity( const BufferType type, const size_t elements, const bool fd = false );
+
+    /**
+     *  Reports a buffer's fill level after frames were added or removed
+     *
+     *  @param[in]  type          Which direction
+     *  @param[in]  pending       Frames now in the buffer
+     *  @param[in]  fd            Selects the FD buffer for that direction
+     *  @return void
+     */
+    void level( const BufferType type, const size_t pending, const bool fd = false );
+
+    /**
+     *  Reports a frame the node saw on the wire, whoever sent it. Feeds the
+     *  bus load measurement.
+     *
+     *  @param[in]  timestamp     When the frame ended
+     *  @param[in]  nominalBits   Bits sent at the nominal rate, including stuffing
+     *  @param[in]  dataBits      Bits sent at the data rate, see Util::frameBits( const FDFrame& )
+     *  @return void
+     */
+    void busy( const size_t timestamp, const size_t nominalBits, const size_t dataBits = 0 );
+
+    /**
+     *  A frame from this node was acknowledged
+     *
+     *  @param[in]  timestamp     When the frame ended
+     *  @return void
+     */
+    void transmitted( const size_t timestamp );
+
+    /**
+     *  A frame passed the filters and was stored in an RX buffer
+     *
+     *  @param[in]  timestamp     When the frame ended
+     *  @return void
+     */
+    void received( const size_t timestamp );
+
+    /**
+     *  A frame passed the filters but the RX buffer was full
+     *  @return void
+     */
+    void overrun();
+
+    /**
+     *  A transmission from this node ended in an error frame
+     *
+     *  @param[in]  ackError      Nobody acknowledged the frame
+     *  @return void
+     */
+    void txError( const bool ackError );
+
+    /**
+     *  Pending frames lost arbitration
+     *
+     *  @param[in]  count         Number of arbitration rounds lost
+     *  @return void
+     */
+    void lostArbitration( const size_t count = 1 );
+
+    /**
+     *  Overrides the software fault confinement counters with hardware values
+     *
+     *  @param[in]  tec           Transmit error counter
+     *  @param[in]  rec           Receive error counter
+     *  @return void
+     */
+    void errorCounters( const uint16_t tec, const uint16_t rec );
+
+    /**
+     *  Builds the status as of a point in time
+     *
+     *  @param[in]  timestamp     Current time, the end of the load window
+     *  @return CANStatus
+     */
+    CANStatus snapshot( const size_t timestamp ) const;
+
+  private:
+    static constexpr size_t BUCKET_US = ( CHIMERA_CAN_STATUS_LOAD_WINDOW_MS * 1000 ) / CHIMERA_CAN_STATUS_LOAD_BUCKETS;
+    static constexpr size_t NO_EPOCH  = static_cast<size_t>( -1 );
+
+    static_assert( BUCKET_US > 0 );
+    static_assert( BUCKET_US < 4000000, "Bucket busy time is counted in a 32-bit nanosecond field" );
+
+    CANStatus mStatus;
+    size_t mBaudRate;
+    size_t mDataBaudRate;
+    size_t mStart; /**< Time the load history starts at */
+
+    std::array<uint32_t, CHIMERA_CAN_STATUS_LOAD_BUCKETS> mBusyNs; /**< Bus busy time in each bucket */
+    std::array<size_t, CHIMERA_CAN_STATUS_LOAD_BUCKETS> mEpoch;    /**< timestamp / BUCKET_US each bucket holds */
+
+    BufferStatus &buffer( const BufferType type, const bool fd );
+  };
+}  // namespace Chimera::CAN
+
+#endif /* !CHIMERA_CAN_STATUS_HPP */
@@ -0,0 +1,234 @@
+/********************************************************************************
+ *  File Name:
+ *    can_timing.hpp
+ *
+ *  Description:
+ *    Constexpr CAN bit timing solver. Given constant inputs the search runs
+ *    entirely at compile time, so impossible settings fail the build and
+ *    open() only has to copy the result into the timing registers:
+ *
+ *      constexpr auto timing = Timing::solve( 80000000, 1000000, 0.875f, 0.5f, 1, 0, Timing::BXCAN );
+ *      static_assert( timing.valid(), "80 MHz can't make 1 Mbit/s" );
+ *
+ *      init.nominalTiming = timing;
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CAN_TIMING_HPP
+#define CHIMERA_CAN_TIMING_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/source/drivers/peripherals/can/can_types.hpp>
+
+namespace Chimera::CAN::Timing
+{
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Register field ranges of a CAN peripheral, in the units BitTiming uses
+   *  rather than the register encodings (which are usually value - 1)
+   */
+  struct Limits
+  {
+    uint16_t prescalerMin;
+    uint16_t prescalerMax;
+    uint16_t timeSeg1Min;
+    uint16_t timeSeg1Max;
+    uint16_t timeSeg2Min;
+    uint16_t timeSeg2Max;
+    uint16_t syncJumpWidthMax;
+  };
+
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr Limits BXCAN         = { 1, 1024, 1, 16, 1, 8, 4 };    /**< STM32 bxCAN */
+  static constexpr Limits FDCAN_NOMINAL = { 1, 512, 2, 256, 2, 128, 128 }; /**< Bosch M_CAN / STM32 FDCAN, NBTP */
+  static constexpr Limits FDCAN_DATA    = { 1, 32, 1, 32, 1, 16, 16 };     /**< Bosch M_CAN / STM32 FDCAN, DBTP */
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Finds the prescaler and segment lengths that best produce a bit rate.
+   *  Candidates outside maxBaudError are rejected. Of the rest, the lowest
+   *  baud error wins, then the sample point closest to the target, then the
+   *  most time quanta per bit for the finest resynchronization.
+   *
+   *  @param[in]  clockHz       Clock feeding the CAN peripheral
+   *  @param[in]  baudRate      Desired bit rate in Hz
+   *  @param[in]  samplePoint   Desired sample point as a fraction of the bit, eg 0.875
+   *  @param[in]  maxBaudError  Largest acceptable baud rate error in percent
+   *  @param[in]  syncJumpWidth Desired SJW, reduced to what the phase 2 segment allows
+   *  @param[in]  timeQuanta    Required time quanta per bit, 0 to let the solver choose
+   *  @param[in]  limits        Peripheral register ranges
+   *  @return BitTiming         Check valid() for whether a solution exists
+   */
+  constexpr BitTiming solve( const size_t clockHz, const size_t baudRate, const float samplePoint,
+                             const float maxBaudError, const uint16_t syncJumpWidth, const size_t timeQuanta,
+                             const Limits &limits )
+  {
+    BitTiming best = { 0, 0, 0, 0, 0, 0, 0 };
+    if ( !clockHz || !baudRate || ( samplePoint <= 0.0f ) || ( samplePoint >= 1.0f ) || ( maxBaudError < 0.0f ) )
+    {
+      return best;
+    }
+
+    const uint32_t targetSP  = static_cast<uint32_t>( ( samplePoint * 1000.0f ) + 0.5f );
+    const uint64_t maxErrPPM = static_cast<uint64_t>( ( maxBaudError * 10000.0f ) + 0.5f );
+    const size_t minTQ       = 1u + limits.timeSeg1Min + limits.timeSeg2Min;
+    const size_t maxTQ       = 1u + limits.timeSeg1Max + limits.timeSeg2Max;
+
+    uint32_t bestSPError = 0;
+
+    for ( size_t brp = limits.prescalerMin; brp <= limits.prescalerMax; brp++ )
+    {
+      /*-------------------------------------------------
+      Only the two quanta counts either side of the ideal
+      can come close to the requested rate
+      -------------------------------------------------*/
+      const uint64_t ideal = static_cast<uint64_t>( clockHz ) / ( static_cast<uint64_t>( brp ) * baudRate );
+      if ( ideal + 1 < minTQ )
+      {
+        break;
+      }
+
+      for ( uint64_t tq = ideal; tq <= ideal + 1; tq++ )
+      {
+        if ( ( tq < minTQ ) || ( tq > maxTQ ) || ( timeQuanta && ( tq != timeQuanta ) ) )
+        {
+          continue;
+        }
+
+        /*-------------------------------------------------
+        Baud error in parts per million
+        -------------------------------------------------*/
+        const uint64_t produced = static_cast<uint64_t>( baudRate ) * brp * tq; /**< Clock needed for an exact match */
+        const uint64_t diff     = ( produced > clockHz ) ? ( produced - clockHz ) : ( clockHz - produced );
+        const uint64_t errPPM   = ( diff * 1000000u ) / produced;
+
+        if ( errPPM > maxErrPPM )
+        {
+          continue;
+        }
+
+        /*-------------------------------------------------
+        The sample point sits after sync + seg1. Clamp the
+        split into the register ranges.
+        -------------------------------------------------*/
+        uint64_t seg1 = ( ( targetSP * tq ) + 500u ) / 1000u;
+        seg1          = ( seg1 > 1u ) ? ( seg1 - 1u ) : 0u;
+
+        if ( ( tq - 1u - seg1 ) < limits.timeSeg2Min )
+        {
+          seg1 = tq - 1u - limits.timeSeg2Min;
+        }
+        else if ( ( tq - 1u - seg1 ) > limits.timeSeg2Max )
+        {
+          seg1 = tq - 1u - limits.timeSeg2Max;
+        }
+
+        if ( ( seg1 < limits.timeSeg1Min ) || ( seg1 > limits.timeSeg1Max ) )
+        {
+          continue;
+        }
+
+        const uint64_t seg2     = tq - 1u - seg1;
+        const uint32_t actualSP = static_cast<uint32_t>( ( ( ( 1u + seg1 ) * 1000u ) + ( tq / 2u ) ) / tq );
+        const uint32_t spError  = ( actualSP > targetSP ) ? ( actualSP - targetSP ) : ( targetSP - actualSP );
+
+        if ( best.valid() )
+        {
+          if ( errPPM != best.baudError )
+          {
+            if ( errPPM > best.baudError )
+            {
+              continue;
+            }
+          }
+          else if ( spError != bestSPError )
+          {
+            if ( spError > bestSPError )
+            {
+              continue;
+            }
+          }
+          else if ( tq <= best.timeQuanta() )
+          {
+            continue;
+          }
+        }
+
+        uint16_t sjw = syncJumpWidth ? syncJumpWidth : 1u;
+        sjw          = ( sjw > seg2 ) ? static_cast<uint16_t>( seg2 ) : sjw;
+        sjw          = ( sjw > limits.syncJumpWidthMax ) ? limits.syncJumpWidthMax : sjw;
+
+        best.prescaler     = static_cast<uint16_t>( brp );
+        best.timeSeg1      = static_cast<uint16_t>( seg1 );
+        best.timeSeg2      = static_cast<uint16_t>( seg2 );
+        best.syncJumpWidth = sjw;
+        best.samplePoint   = static_cast<uint16_t>( actualSP );
+        best.baudError     = static_cast<uint32_t>( errPPM );
+        best.baudRate      = static_cast<size_t>( ( clockHz + ( ( brp * tq ) / 2u ) ) / ( brp * tq ) );
+        bestSPError        = spError;
+      }
+    }
+
+    return best;
+  }
+
+
+  /**
+   *  Solves for the nominal bit timing described by a HardwareInit, for
+   *  backends that still need to search at open()
+   *
+   *  @param[in]  clockHz       Clock feeding the CAN peripheral
+   *  @param[in]  init          Requested settings
+   *  @param[in]  limits        Peripheral register ranges
+   *  @return BitTiming
+   */
+  constexpr BitTiming solve( const size_t clockHz, const HardwareInit &init, const Limits &limits )
+  {
+    return solve( clockHz, init.baudRate, init.samplePointPercent, init.maxBaudError, init.resyncJumpWidth,
+                  init.timeQuanta, limits );
+  }
+
+
+  /**
+   *  Solves for the CAN FD data phase timing described by a HardwareInit
+   *
+   *  @param[in]  clockHz       Clock feeding the CAN peripheral
+   *  @param[in]  init          Requested settings
+   *  @param[in]  limits        Peripheral data phase register ranges
+   *  @return BitTiming
+   */
+  constexpr BitTiming solveData( const size_t clockHz, const HardwareInit &init, const Limits &limits )
+  {
+    return solve( clockHz, init.dataBaudRate, init.dataSamplePointPercent, init.maxBaudError, init.resyncJumpWidth,
+                  0, limits );
+  }
+
+
+  /**
+   *  Picks the timing a backend should program: the precomputed one if the
+   *  caller supplied it, otherwise the result of a search
+   *
+   *  @param[in]  clockHz       Clock feeding the CAN peripheral
+   *  @param[in]  init          Requested settings
+   *  @param[in]  limits        Peripheral register ranges
+   *  @return BitTiming
+   */
+  constexpr BitTiming resolve( const size_t clockHz, const HardwareInit &init, const Limits &limits )
+  {
+    return init.nominalTiming.valid() ? init.nominalTiming : solve( clockHz, init, limits );
+  }
+}  // namespace Chimera::CAN::Timing
+
+#endif /* !CHIMERA_CAN_TIMING_HPP */
@@ -29,6 +29,7 @@ namespace Chimera::CAN
   -------------------------------------------------------------------------------*/
   class Driver;
   struct BasicFrame;
+  struct FDFrame;
 
   /*-------------------------------------------------------------------------------
   Aliases
@@ -43,9 +44,10 @@ namespace Chimera::CAN
   /*-------------------------------------------------------------------------------
   Constants
   -------------------------------------------------------------------------------*/
-  static constexpr size_t MAX_PAYLOAD_LENGTH = 8;  // Bytes
-  static constexpr size_t ID_MASK_11_BIT     = 0x000007FF;
-  static constexpr size_t ID_MASK_29_BIT     = 0x1FFFFFFF;
+  static constexpr size_t MAX_PAYLOAD_LENGTH    = 8;   // Bytes
+  static constexpr size_t MAX_FD_PAYLOAD_LENGTH = 64;  // Bytes
+  static constexpr size_t ID_MASK_11_BIT        = 0x000007FF;
+  static constexpr size_t ID_MASK_29_BIT        = 0x1FFFFFFF;
 
   /*-------------------------------------------------
   Special message ID used to indicate to the driver
@@ -189,12 +191,123 @@ namespace Chimera::CAN
   };
 
 
+  /**
+   *  CAN FD data frame. Kept separate from BasicFrame so classic frames and
+   *  their buffers don't grow. FD has no remote frames.
+   */
+  struct FDFrame
+  {
+    Identifier_t id;                       /**< Message identifier, sized according to idMode */
+    IdType idMode;                         /**< Specifies either standard or extended ID */
+    bool bitRateSwitch;                    /**< Send the data phase at HardwareInit::dataBaudRate */
+    bool errorPassive;                     /**< RX only: transmitter was error passive (ESI bit) */
+    DataLength_t dataLength;               /**< Bytes in the data field. Must be a length a DLC can encode. */
+    uint8_t filterIndex;                   /**< RX only: Which filter this frame matched against */
+    uint8_t data[ MAX_FD_PAYLOAD_LENGTH ]; /**< Data payload */
+
+    void clear()
+    {
+      id            = 0;
+      idMode        = IdType::UNKNOWN;
+      bitRateSwitch = false;
+      errorPassive  = false;
+      dataLength    = 0;
+      filterIndex   = 0;
+      memset( data, 0, MAX_FD_PAYLOAD_LENGTH );
+    }
+
+    bool operator==( const FDFrame &rhs ) const
+    {
+      /* clang-format off */
+      return ( this->id == rhs.id ) &&
+             ( this->idMode == rhs.idMode ) &&
+             ( this->bitRateSwitch == rhs.bitRateSwitch ) &&
+             ( this->dataLength == rhs.dataLength ) &&
+             ( memcmp( this->data, rhs.data, this->dataLength ) == 0 );
+      /* clang-format on */
+    }
+
+    bool operator!=( const FDFrame &rhs ) const
+    {
+      return !( *this == rhs );
+    }
+  };
+
+
+  struct BufferStatus
+  {
+    size_t pending;   /**< Frames currently queued */
+    size_t highWater; /**< Most frames queued at once since the status was reset */
+    size_t capacity;  /**< Frames the buffer can hold, 0 if it isn't in use */
+
+    void clear()
+    {
+      pending   = 0;
+      highWater = 0;
+      capacity  = 0;
+    }
+  };
+
+
+  /**
+   *  Snapshot of a channel's health. Counters accumulate from open() or the
+   *  last resetStatus(), timestamps are in microseconds on the same clock
+   *  as the RX timestamps from receive().
+   */
   struct CANStatus
   {
-    // Buffer fill levels
-    // Last TX/RX timestamps
-    // Listening/not listening
-    // Identifiers being listened to
+    /*-------------------------------------------------
+    Buffers
+    -------------------------------------------------*/
+    BufferStatus txBuffer;
+    BufferStatus rxBuffer;
+    BufferStatus fdTxBuffer;
+    BufferStatus fdRxBuffer;
+
+    /*-------------------------------------------------
+    Traffic
+    -------------------------------------------------*/
+    size_t txFrames;        /**< Frames transmitted successfully */
+    size_t rxFrames;        /**< Frames stored in an RX buffer */
+    size_t rxOverruns;      /**< Frames that passed the filters but found the RX buffer full */
+    size_t txErrors;        /**< Transmissions that ended in an error frame */
+    size_t arbitrationLost; /**< Times a pending frame lost arbitration */
+    uint32_t lastTx;        /**< When the last successful transmission finished */
+    uint32_t lastRx;        /**< When the last stored frame finished arriving */
+
+    /*-------------------------------------------------
+    Fault confinement
+    -------------------------------------------------*/
+    uint16_t txErrorCount; /**< TEC */
+    uint16_t rxErrorCount; /**< REC */
+    bool errorPassive;     /**< Either counter is above 127 */
+    bool busOff;           /**< TEC is above 255 */
+
+    /*-------------------------------------------------
+    Load
+    -------------------------------------------------*/
+    float busLoad; /**< Percent of the last CHIMERA_CAN_STATUS_LOAD_WINDOW_MS the bus was busy */
+
+    void clear()
+    {
+      txBuffer.clear();
+      rxBuffer.clear();
+      fdTxBuffer.clear();
+      fdRxBuffer.clear();
+
+      txFrames        = 0;
+      rxFrames        = 0;
+      rxOverruns      = 0;
+      txErrors        = 0;
+      arbitrationLost = 0;
+      lastTx          = 0;
+      lastRx          = 0;
+      txErrorCount    = 0;
+      rxErrorCount    = 0;
+      errorPassive    = false;
+      busOff          = false;
+      busLoad         = 0.0f;
+    }
   };
 
 
@@ -213,6 +326,43 @@ namespace Chimera::CAN
   };
 
 
+  /**
+   *  Bit timing register values, normally produced by Timing::solve(). One
+   *  bit lasts 1 + timeSeg1 + timeSeg2 time quanta of prescaler clock cycles.
+   */
+  struct BitTiming
+  {
+    uint16_t prescaler;     /**< BRP: peripheral clock cycles per time quantum */
+    uint16_t timeSeg1;      /**< Propagation plus phase 1 segment, in time quanta */
+    uint16_t timeSeg2;      /**< Phase 2 segment, in time quanta */
+    uint16_t syncJumpWidth; /**< SJW, in time quanta */
+    uint16_t samplePoint;   /**< Resulting sample point in tenths of a percent */
+    uint32_t baudError;     /**< Resulting baud rate error in parts per million */
+    size_t baudRate;        /**< Resulting baud rate in Hz, 0 if there was no solution */
+
+    constexpr bool valid() const
+    {
+      return baudRate != 0;
+    }
+
+    constexpr size_t timeQuanta() const
+    {
+      return 1u + timeSeg1 + timeSeg2;
+    }
+
+    void clear()
+    {
+      prescaler     = 0;
+      timeSeg1      = 0;
+      timeSeg2      = 0;
+      syncJumpWidth = 0;
+      samplePoint   = 0;
+      baudError     = 0;
+      baudRate      = 0;
+    }
+  };
+
+
   struct HardwareInit
   {
     Channel channel;          /**< Channel the config settings are for */
@@ -225,6 +375,20 @@ namespace Chimera::CAN
     uint8_t timeQuanta;       /**< Number of intervals each bit is divided into (Recommend 16 or 8) */
     uint8_t resyncJumpWidth;  /**< Number of time quanta allowed to shift for syncing (Recommend 1) */
     float maxBaudError;       /**< Max allowable baud rate error abs(%) */
+    DebugMode debugMode;      /**< Test mode to run in, or UNKNOWN for normal operation */
+    BitTiming nominalTiming;  /**< Precomputed timing for baudRate. If valid, backends use it instead of searching. */
+
+    /*-------------------------------------------------
+    CAN FD. Only used when fdMode is set.
+    -------------------------------------------------*/
+    bool fdMode;                  /**< Enable FD frames alongside classic frames */
+    size_t dataBaudRate;          /**< Data phase rate in Hz for frames with bitRateSwitch set */
+    float dataSamplePointPercent; /**< Sample point for the data phase */
+    FDFrame *fdTxBuffer;          /**< Buffer for queueing FD TX frames */
+    size_t fdTxElements;          /**< Number of frames the FD TX buffer can hold */
+    FDFrame *fdRxBuffer;          /**< Buffer for queueing FD RX frames */
+    size_t fdRxElements;          /**< Number of frames the FD RX buffer can hold */
+    BitTiming dataTiming;         /**< Precomputed timing for dataBaudRate, used like nominalTiming */
 
     void clear()
     {
@@ -237,6 +401,18 @@ namespace Chimera::CAN
       resyncJumpWidth    = 1;
       samplePointPercent = 0.875;
       baudRate           = 100000;
+      maxBaudError       = 0.5;
+      debugMode          = DebugMode::UNKNOWN;
+      nominalTiming.clear();
+
+      fdMode                 = false;
+      dataBaudRate           = 2000000;
+      dataSamplePointPercent = 0.75;
+      fdTxBuffer             = nullptr;
+      fdTxElements           = 0;
+      fdRxBuffer             = nullptr;
+      fdRxElements           = 0;
+      dataTiming.clear();
     }
   };
 
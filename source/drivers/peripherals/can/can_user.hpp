@@ -49,11 +49,19 @@ namespace Chimera::CAN
     Chimera::Status_t open( const DriverConfig &cfg );
     Chimera::Status_t close();
     CANStatus getStatus();
+    void resetStatus();
     Chimera::Status_t send( const BasicFrame &frame );
     Chimera::Status_t receive( BasicFrame &frame );
+    Chimera::Status_t receive( BasicFrame &frame, uint32_t &timestamp );
+    size_t sendBurst( const BasicFrame *const frames, const size_t count );
+    size_t receiveBurst( BasicFrame *const frames, const size_t count );
     Chimera::Status_t filter( const Filter *const list, const size_t size );
     Chimera::Status_t flush( BufferType buffer );
     size_t available();
+    Chimera::Status_t sendFD( const FDFrame &frame );
+    Chimera::Status_t receiveFD( FDFrame &frame );
+    Chimera::Status_t receiveFD( FDFrame &frame, uint32_t &timestamp );
+    size_t availableFD();
 
     /*-------------------------------------------------
     Interface: Listener
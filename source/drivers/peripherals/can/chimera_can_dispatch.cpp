@@ -0,0 +1,342 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_can_dispatch.cpp
+ *
+ *  Description:
+ *    Routes received CAN frames to per-ID callbacks or queues
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/can>
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/can/can_hash.hpp>
+
+namespace Chimera::CAN
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint32_t EXTENDED_FLAG = 0x80000000;
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Folds the ID mode into the ID so standard and extended frames with the
+   *  same numeric ID get separate routes
+   */
+  static inline uint32_t makeKey( const Identifier_t id, const IdType mode )
+  {
+    if ( mode == IdType::EXTENDED )
+    {
+      return ( id & ID_MASK_29_BIT ) | EXTENDED_FLAG;
+    }
+
+    return id & ID_MASK_11_BIT;
+  }
+
+
+  /**
+   *  Key accessor for the shared hash table probes
+   */
+  template<typename EntryType>
+  static inline uint32_t entryKey( const EntryType &entry )
+  {
+    return entry.key;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Dispatcher Implementation
+  -------------------------------------------------------------------------------*/
+  Dispatcher::Dispatcher()
+  {
+    clear();
+  }
+
+
+  Dispatcher::~Dispatcher()
+  {
+  }
+
+
+  void Dispatcher::clear()
+  {
+    for ( auto &entry : mTable )
+    {
+      entry.key = KEY_FREE;
+    }
+
+    mNumEntries = 0;
+    mNumRanges  = 0;
+    mDefault    = nullptr;
+    mUnmatched  = 0;
+  }
+
+
+  Chimera::Status_t Dispatcher::route( const Identifier_t id, const IdType mode, FrameCallback_t callback )
+  {
+    if ( !callback )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    return insert( id, mode, Target{ callback, nullptr, RouteStats{ 0, 0 } } );
+  }
+
+
+  Chimera::Status_t Dispatcher::route( const Identifier_t id, const IdType mode, FrameQueue &queue )
+  {
+    return insert( id, mode, Target{ nullptr, &queue, RouteStats{ 0, 0 } } );
+  }
+
+
+  Chimera::Status_t Dispatcher::route( const Filter &range, FrameCallback_t callback )
+  {
+    if ( !callback )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    return insert( range, Target{ callback, nullptr, RouteStats{ 0, 0 } } );
+  }
+
+
+  Chimera::Status_t Dispatcher::route( const Filter &range, FrameQueue &queue )
+  {
+    return insert( range, Target{ nullptr, &queue, RouteStats{ 0, 0 } } );
+  }
+
+
+  Chimera::Status_t Dispatcher::remove( const Identifier_t id, const IdType mode )
+  {
+    size_t hole = findSlot( makeKey( id, mode ) );
+    if ( hole >= mTable.size() )
+    {
+      return Chimera::Status::NOT_FOUND;
+    }
+
+    /*-------------------------------------------------
+    Backward shift deletion: pull later members of the
+    probe run into the hole unless their home slot sits
+    between the hole and where they are now.
+    -------------------------------------------------*/
+    mTable[ hole ].key = KEY_FREE;
+    mNumEntries--;
+
+    size_t next = hole;
+    while ( true )
+    {
+      next = ( next + 1 ) & SLOT_MASK;
+      if ( mTable[ next ].key == KEY_FREE )
+      {
+        break;
+      }
+
+      const size_t home = Internal::hashSlot( mTable[ next ].key, SLOT_MASK );
+      const bool stays  = ( hole <= next ) ? ( ( hole < home ) && ( home <= next ) )
+                                           : ( ( hole < home ) || ( home <= next ) );
+
+      if ( !stays )
+      {
+        mTable[ hole ]     = mTable[ next ];
+        mTable[ next ].key = KEY_FREE;
+        hole               = next;
+      }
+    }
+
+    return Chimera::Status::OK;
+  }
+
+
+  void Dispatcher::setDefault( FrameCallback_t callback )
+  {
+    mDefault = callback;
+  }
+
+
+  bool Dispatcher::dispatch( const BasicFrame &frame )
+  {
+    const uint32_t key = makeKey( frame.id, frame.idMode );
+
+    /*-------------------------------------------------
+    Exact routes first, they're the common case
+    -------------------------------------------------*/
+    const size_t slot = findSlot( key );
+    if ( slot < mTable.size() )
+    {
+      deliver( mTable[ slot ].target, frame );
+      return true;
+    }
+
+    /*-------------------------------------------------
+    Then the ranges, in the order they were added
+    -------------------------------------------------*/
+    const bool extended = ( frame.idMode == IdType::EXTENDED );
+    const uint32_t id   = key & ~EXTENDED_FLAG;
+
+    for ( size_t idx = 0; idx < mNumRanges; idx++ )
+    {
+      auto &range = mRanges[ idx ];
+      if ( ( range.filter.extended == extended ) && ( ( id & range.filter.mask ) == range.filter.id ) )
+      {
+        deliver( range.target, frame );
+        return true;
+      }
+    }
+
+    mUnmatched++;
+    if ( mDefault )
+    {
+      mDefault( &frame );
+    }
+
+    return false;
+  }
+
+
+  size_t Dispatcher::dispatch( const BasicFrame *const frames, const size_t count )
+  {
+    if ( !frames )
+    {
+      return 0;
+    }
+
+    size_t matched = 0;
+    for ( size_t idx = 0; idx < count; idx++ )
+    {
+      matched += dispatch( frames[ idx ] ) ? 1 : 0;
+    }
+
+    return matched;
+  }
+
+
+  size_t Dispatcher::process( Driver_rPtr driver )
+  {
+    if ( !driver )
+    {
+      return 0;
+    }
+
+    size_t total = 0;
+    size_t count = 0;
+
+    do
+    {
+      count = driver->receiveBurst( mBatch.data(), mBatch.size() );
+      dispatch( mBatch.data(), count );
+      total += count;
+    } while ( count == mBatch.size() );
+
+    return total;
+  }
+
+
+  bool Dispatcher::stats( const Identifier_t id, const IdType mode, RouteStats &stats ) const
+  {
+    const size_t slot = findSlot( makeKey( id, mode ) );
+    if ( slot >= mTable.size() )
+    {
+      return false;
+    }
+
+    stats = mTable[ slot ].target.stats;
+    return true;
+  }
+
+
+  bool Dispatcher::rangeStats( const size_t index, RouteStats &stats ) const
+  {
+    if ( index >= mNumRanges )
+    {
+      return false;
+    }
+
+    stats = mRanges[ index ].target.stats;
+    return true;
+  }
+
+
+  size_t Dispatcher::unmatched() const
+  {
+    return mUnmatched;
+  }
+
+
+  Chimera::Status_t Dispatcher::insert( const Identifier_t id, const IdType mode, const Target &target )
+  {
+    if ( ( mode != IdType::STANDARD ) && ( mode != IdType::EXTENDED ) )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    const uint32_t key = makeKey( id, mode );
+
+    /*-------------------------------------------------
+    Replace an existing route in place
+    -------------------------------------------------*/
+    const size_t existing = findSlot( key );
+    if ( existing < mTable.size() )
+    {
+      mTable[ existing ].target = target;
+      return Chimera::Status::OK;
+    }
+
+    if ( mNumEntries >= SLOT_LIMIT )
+    {
+      return Chimera::Status::FULL;
+    }
+
+    const size_t slot = Internal::freeSlot( mTable, key, KEY_FREE, entryKey<Entry> );
+
+    mTable[ slot ].key    = key;
+    mTable[ slot ].target = target;
+    mNumEntries++;
+    return Chimera::Status::OK;
+  }
+
+
+  Chimera::Status_t Dispatcher::insert( const Filter &range, const Target &target )
+  {
+    if ( mNumRanges >= mRanges.size() )
+    {
+      return Chimera::Status::FULL;
+    }
+
+    const uint32_t mask = range.mask & ( range.extended ? ID_MASK_29_BIT : ID_MASK_11_BIT );
+
+    auto &entry       = mRanges[ mNumRanges ];
+    entry.filter      = range;
+    entry.filter.mask = mask;
+    entry.filter.id   = range.id & mask;
+    entry.target      = target;
+    mNumRanges++;
+    return Chimera::Status::OK;
+  }
+
+
+  size_t Dispatcher::findSlot( const uint32_t key ) const
+  {
+    return Internal::findSlot( mTable, key, KEY_FREE, entryKey<Entry> );
+  }
+
+
+  void Dispatcher::deliver( Target &target, const BasicFrame &frame )
+  {
+    target.stats.frames++;
+
+    if ( target.callback )
+    {
+      target.callback( &frame );
+    }
+    else if ( target.queue && !target.queue->push( frame ) )
+    {
+      target.stats.dropped++;
+    }
+  }
+}  // namespace Chimera::CAN
@@ -0,0 +1,223 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_can_filter.cpp
+ *
+ *  Description:
+ *    Software acceptance filtering for CAN identifiers
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/can>
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/can/can_hash.hpp>
+
+namespace Chimera::CAN
+{
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Key accessor for the shared hash table probes
+   */
+  static inline uint32_t slotKey( const uint32_t slot )
+  {
+    return slot;
+  }
+
+  /*-------------------------------------------------------------------------------
+  SoftwareFilter Implementation
+  -------------------------------------------------------------------------------*/
+  SoftwareFilter::SoftwareFilter()
+  {
+    clear();
+  }
+
+
+  SoftwareFilter::~SoftwareFilter()
+  {
+  }
+
+
+  void SoftwareFilter::clear()
+  {
+    mActive = false;
+    mStandard.fill( 0 );
+    mExtended.fill( EXT_FREE );
+    mNumExtended = 0;
+    mNumExtMasks = 0;
+
+    for ( auto &filter : mExtMasks )
+    {
+      filter.clear();
+    }
+  }
+
+
+  Chimera::Status_t SoftwareFilter::add( const Filter &filter )
+  {
+    if ( !filter.extended )
+    {
+      /*-------------------------------------------------
+      Expand the mask into the bitmap. Only 2048 IDs
+      exist, so this is cheap and keeps lookups O(1).
+      -------------------------------------------------*/
+      const uint32_t mask   = filter.mask & ID_MASK_11_BIT;
+      const uint32_t target = filter.id & mask;
+
+      for ( uint32_t id = 0; id <= ID_MASK_11_BIT; id++ )
+      {
+        if ( ( id & mask ) == target )
+        {
+          mStandard[ id / 32 ] |= ( 1u << ( id % 32 ) );
+        }
+      }
+
+      mActive = true;
+      return Chimera::Status::OK;
+    }
+
+    const uint32_t mask = filter.mask & ID_MASK_29_BIT;
+    if ( mask != ID_MASK_29_BIT )
+    {
+      if ( mNumExtMasks >= mExtMasks.size() )
+      {
+        return Chimera::Status::FULL;
+      }
+
+      mExtMasks[ mNumExtMasks ]      = filter;
+      mExtMasks[ mNumExtMasks ].mask = mask;
+      mNumExtMasks++;
+      mActive = true;
+      return Chimera::Status::OK;
+    }
+
+    /*-------------------------------------------------
+    Exact extended ID: insert with linear probing
+    -------------------------------------------------*/
+    const uint32_t id = filter.id & ID_MASK_29_BIT;
+    if ( findExtended( id ) )
+    {
+      return Chimera::Status::OK;
+    }
+
+    if ( mNumExtended >= EXT_LIMIT )
+    {
+      return Chimera::Status::FULL;
+    }
+
+    const size_t slot = Internal::freeSlot( mExtended, id, EXT_FREE, slotKey );
+
+    mExtended[ slot ] = id;
+    mNumExtended++;
+    mActive = true;
+    return Chimera::Status::OK;
+  }
+
+
+  Chimera::Status_t SoftwareFilter::configure( const Filter *const list, const size_t size )
+  {
+    if ( !list && size )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    clear();
+
+    for ( size_t idx = 0; idx < size; idx++ )
+    {
+      auto result = add( list[ idx ] );
+      if ( result != Chimera::Status::OK )
+      {
+        return result;
+      }
+    }
+
+    return Chimera::Status::OK;
+  }
+
+
+  bool SoftwareFilter::accept( const Identifier_t id, const IdType mode ) const
+  {
+    if ( !mActive )
+    {
+      return true;
+    }
+
+    if ( mode == IdType::STANDARD )
+    {
+      const uint32_t key = id & ID_MASK_11_BIT;
+      return ( mStandard[ key / 32 ] >> ( key % 32 ) ) & 1u;
+    }
+
+    const uint32_t key = id & ID_MASK_29_BIT;
+    if ( findExtended( key ) )
+    {
+      return true;
+    }
+
+    for ( size_t idx = 0; idx < mNumExtMasks; idx++ )
+    {
+      const auto &filter = mExtMasks[ idx ];
+      if ( ( key & filter.mask ) == ( filter.id & filter.mask ) )
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+
+  bool SoftwareFilter::accept( const BasicFrame &frame ) const
+  {
+    return accept( frame.id, frame.idMode );
+  }
+
+
+  bool SoftwareFilter::accept( const FDFrame &frame ) const
+  {
+    return accept( frame.id, frame.idMode );
+  }
+
+
+  size_t SoftwareFilter::apply( BasicFrame *const frames, const size_t count ) const
+  {
+    if ( !frames || !mActive )
+    {
+      return frames ? count : 0;
+    }
+
+    size_t kept = 0;
+    for ( size_t idx = 0; idx < count; idx++ )
+    {
+      if ( accept( frames[ idx ] ) )
+      {
+        if ( kept != idx )
+        {
+          frames[ kept ] = frames[ idx ];
+        }
+
+        kept++;
+      }
+    }
+
+    return kept;
+  }
+
+
+  bool SoftwareFilter::active() const
+  {
+    return mActive;
+  }
+
+
+  bool SoftwareFilter::findExtended( const uint32_t id ) const
+  {
+    return Internal::findSlot( mExtended, id, EXT_FREE, slotKey ) < mExtended.size();
+  }
+}  // namespace Chimera::CAN
@@ -0,0 +1,738 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_can_isotp.cpp
+ *
+ *  Description:
+ *    ISO 15765-2 (ISO-TP) transport over Chimera CAN
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+/* Chimera Includes */
+#include <Chimera/can>
+#include <Chimera/common>
+
+namespace Chimera::CAN::ISOTP
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint8_t PCI_SINGLE       = 0x0;
+  static constexpr uint8_t PCI_FIRST        = 0x1;
+  static constexpr uint8_t PCI_CONSECUTIVE  = 0x2;
+  static constexpr uint8_t PCI_FLOW_CONTROL = 0x3;
+
+  static constexpr uint8_t FC_CONTINUE = 0x0;
+  static constexpr uint8_t FC_WAIT     = 0x1;
+  static constexpr uint8_t FC_OVERFLOW = 0x2;
+
+  static constexpr size_t FRAME_SIZE = MAX_PAYLOAD_LENGTH;
+  static constexpr size_t CF_PAYLOAD = FRAME_SIZE - 1;
+  static constexpr size_t TX_BATCH   = 8; /**< Consecutive frames handed to sendBurst() at once */
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Converts the raw STmin byte to microseconds. Reserved values are to be
+   *  treated as the longest legal gap.
+   */
+  static size_t stMinToMicros( const uint8_t raw )
+  {
+    if ( raw <= 0x7F )
+    {
+      return static_cast<size_t>( raw ) * 1000;
+    }
+    else if ( ( raw >= 0xF1 ) && ( raw <= 0xF9 ) )
+    {
+      return static_cast<size_t>( raw - 0xF0 ) * 100;
+    }
+
+    return 127000;
+  }
+
+
+  /**
+   *  Wrap safe check for a timestamp having been reached
+   */
+  static inline bool reached( const size_t now, const size_t target )
+  {
+    return static_cast<intptr_t>( now - target ) >= 0;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Session Implementation
+  -------------------------------------------------------------------------------*/
+  Session::Session() : mDriver( nullptr ), mRxBuffer( nullptr ), mRxSize( 0 )
+  {
+    mConfig.clear();
+    close();
+  }
+
+
+  Session::~Session()
+  {
+  }
+
+
+  Chimera::Status_t Session::open( Driver_rPtr driver, const SessionConfig &cfg )
+  {
+    if ( !driver || ( cfg.idMode == IdType::UNKNOWN ) || ( cfg.txId == cfg.rxId ) )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    close();
+    mDriver = driver;
+    mConfig = cfg;
+    return Chimera::Status::OK;
+  }
+
+
+  void Session::close()
+  {
+    mDriver      = nullptr;
+    mTxState     = State::IDLE;
+    mTxResult    = Chimera::Status::OK;
+    mTxData      = nullptr;
+    mTxLength    = 0;
+    mTxOffset    = 0;
+    mTxSN        = 0;
+    mTxBlockLeft = 0;
+    mTxGapUs     = 0;
+    mTxNextUs    = 0;
+    mTxDeadline  = 0;
+    mTxWaits     = 0;
+
+    mRxState      = State::IDLE;
+    mRxResult     = Chimera::Status::OK;
+    mRxLength     = 0;
+    mRxOffset     = 0;
+    mRxSN         = 0;
+    mRxBlockCount = 0;
+    mRxDeadline   = 0;
+    mFlowPending  = false;
+  }
+
+
+  Chimera::Status_t Session::setRxBuffer( uint8_t *const buffer, const size_t size )
+  {
+    if ( !buffer || !size )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+    else if ( mRxState == State::TRANSFERRING )
+    {
+      return Chimera::Status::BUSY;
+    }
+
+    mRxBuffer = buffer;
+    mRxSize   = size;
+    return Chimera::Status::OK;
+  }
+
+
+  Chimera::Status_t Session::send( const uint8_t *const data, const size_t length )
+  {
+    if ( !mDriver )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+    else if ( !data || !length || ( static_cast<uint64_t>( length ) > MAX_LENGTH ) )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+    else if ( ( mTxState == State::WAIT_FLOW_CONTROL ) || ( mTxState == State::TRANSFERRING ) )
+    {
+      return Chimera::Status::BUSY;
+    }
+
+    BasicFrame frame;
+
+    /*-------------------------------------------------
+    Short enough for a single frame
+    -------------------------------------------------*/
+    if ( length <= SF_MAX_LENGTH )
+    {
+      buildFrame( frame, 1 + length );
+      frame.data[ 0 ] = static_cast<uint8_t>( ( PCI_SINGLE << 4 ) | length );
+      memcpy( &frame.data[ 1 ], data, length );
+
+      auto result = mDriver->send( frame );
+      if ( result == Chimera::Status::OK )
+      {
+        finishTx( Chimera::Status::OK );
+      }
+
+      return result;
+    }
+
+    /*-------------------------------------------------
+    First frame, using the 32-bit length escape when
+    12 bits aren't enough
+    -------------------------------------------------*/
+    size_t header = 2;
+    buildFrame( frame, FRAME_SIZE );
+
+    if ( length <= FF_MAX_LENGTH )
+    {
+      frame.data[ 0 ] = static_cast<uint8_t>( ( PCI_FIRST << 4 ) | ( ( length >> 8 ) & 0x0F ) );
+      frame.data[ 1 ] = static_cast<uint8_t>( length & 0xFF );
+    }
+    else
+    {
+      const uint32_t wide = static_cast<uint32_t>( length );
+      frame.data[ 0 ]     = PCI_FIRST << 4;
+      frame.data[ 1 ]     = 0;
+      frame.data[ 2 ]     = static_cast<uint8_t>( wide >> 24 );
+      frame.data[ 3 ]     = static_cast<uint8_t>( wide >> 16 );
+      frame.data[ 4 ]     = static_cast<uint8_t>( wide >> 8 );
+      frame.data[ 5 ]     = static_cast<uint8_t>( wide );
+      header              = 6;
+    }
+
+    memcpy( &frame.data[ header ], data, FRAME_SIZE - header );
+
+    auto result = mDriver->send( frame );
+    if ( result != Chimera::Status::OK )
+    {
+      return result;
+    }
+
+    mTxData     = data;
+    mTxLength   = length;
+    mTxOffset   = FRAME_SIZE - header;
+    mTxSN       = 1;
+    mTxWaits    = 0;
+    mTxDeadline = Chimera::millis() + mConfig.timeout;
+    mTxResult   = Chimera::Status::BUSY;
+    mTxState    = State::WAIT_FLOW_CONTROL;
+    return Chimera::Status::OK;
+  }
+
+
+  bool Session::handle( const BasicFrame &frame )
+  {
+    if ( !mDriver || ( frame.id != mConfig.rxId ) || ( frame.idMode != mConfig.idMode ) )
+    {
+      return false;
+    }
+
+    if ( !frame.dataLength || ( frame.frameType == FrameType::REMOTE ) )
+    {
+      return true;
+    }
+
+    switch ( frame.data[ 0 ] >> 4 )
+    {
+      case PCI_SINGLE:
+        onSingleFrame( frame );
+        break;
+
+      case PCI_FIRST:
+        onFirstFrame( frame );
+        break;
+
+      case PCI_CONSECUTIVE:
+        onConsecutiveFrame( frame );
+        break;
+
+      case PCI_FLOW_CONTROL:
+        onFlowControl( frame );
+        break;
+
+      default:
+        break;
+    }
+
+    return true;
+  }
+
+
+  void Session::poll()
+  {
+    if ( !mDriver )
+    {
+      return;
+    }
+
+    const size_t now = Chimera::millis();
+
+    /*-------------------------------------------------
+    Transmit direction
+    -------------------------------------------------*/
+    if ( mTxState == State::TRANSFERRING )
+    {
+      pumpConsecutive();
+    }
+    else if ( ( mTxState == State::WAIT_FLOW_CONTROL ) && reached( now, mTxDeadline ) )
+    {
+      finishTx( Chimera::Status::TIMEOUT );
+    }
+
+    /*-------------------------------------------------
+    Receive direction
+    -------------------------------------------------*/
+    if ( mRxState == State::TRANSFERRING )
+    {
+      if ( mFlowPending )
+      {
+        mFlowPending = !sendFlowControl( FC_CONTINUE );
+      }
+
+      if ( reached( now, mRxDeadline ) )
+      {
+        finishRx( Chimera::Status::TIMEOUT );
+      }
+    }
+  }
+
+
+  bool Session::receive( size_t &length )
+  {
+    if ( mRxState != State::COMPLETE )
+    {
+      return false;
+    }
+
+    length   = mRxLength;
+    mRxState = State::IDLE;
+    return true;
+  }
+
+
+  State Session::txState() const
+  {
+    return mTxState;
+  }
+
+
+  State Session::rxState() const
+  {
+    return mRxState;
+  }
+
+
+  Chimera::Status_t Session::txResult() const
+  {
+    return mTxResult;
+  }
+
+
+  Chimera::Status_t Session::rxResult() const
+  {
+    return mRxResult;
+  }
+
+
+  const SessionConfig &Session::config() const
+  {
+    return mConfig;
+  }
+
+
+  void Session::onSingleFrame( const BasicFrame &frame )
+  {
+    const size_t length = frame.data[ 0 ] & 0x0F;
+    if ( !length || ( length > SF_MAX_LENGTH ) || ( ( 1u + length ) > frame.dataLength ) )
+    {
+      return;
+    }
+
+    /*-------------------------------------------------
+    An unread message keeps the buffer. Otherwise a
+    single frame replaces any reception in progress.
+    -------------------------------------------------*/
+    if ( mRxState == State::COMPLETE )
+    {
+      return;
+    }
+    else if ( !mRxBuffer || ( length > mRxSize ) )
+    {
+      finishRx( Chimera::Status::FULL );
+      return;
+    }
+
+    memcpy( mRxBuffer, &frame.data[ 1 ], length );
+    mRxLength    = length;
+    mRxOffset    = length;
+    mFlowPending = false;
+    mRxResult    = Chimera::Status::OK;
+    mRxState     = State::COMPLETE;
+  }
+
+
+  void Session::onFirstFrame( const BasicFrame &frame )
+  {
+    if ( frame.dataLength < FRAME_SIZE )
+    {
+      return;
+    }
+
+    size_t header = 2;
+    size_t length = ( static_cast<size_t>( frame.data[ 0 ] & 0x0F ) << 8 ) | frame.data[ 1 ];
+
+    if ( !length )
+    {
+      const uint32_t wide = ( static_cast<uint32_t>( frame.data[ 2 ] ) << 24 ) |
+                            ( static_cast<uint32_t>( frame.data[ 3 ] ) << 16 ) |
+                            ( static_cast<uint32_t>( frame.data[ 4 ] ) << 8 ) | frame.data[ 5 ];
+
+      length = wide;
+      header = 6;
+
+      if ( wide <= FF_MAX_LENGTH )
+      {
+        return;
+      }
+    }
+    else if ( length <= SF_MAX_LENGTH )
+    {
+      return;
+    }
+
+    /*-------------------------------------------------
+    Refuse what won't fit, including while an unread
+    message still occupies the buffer
+    -------------------------------------------------*/
+    if ( ( mRxState == State::COMPLETE ) || !mRxBuffer || ( length > mRxSize ) )
+    {
+      sendFlowControl( FC_OVERFLOW );
+      if ( mRxState != State::COMPLETE )
+      {
+        finishRx( Chimera::Status::FULL );
+      }
+
+      return;
+    }
+
+    memcpy( mRxBuffer, &frame.data[ header ], FRAME_SIZE - header );
+    mRxLength     = length;
+    mRxOffset     = FRAME_SIZE - header;
+    mRxSN         = 1;
+    mRxBlockCount = 0;
+    mRxDeadline   = Chimera::millis() + mConfig.timeout;
+    mRxResult     = Chimera::Status::BUSY;
+    mRxState      = State::TRANSFERRING;
+    mFlowPending  = !sendFlowControl( FC_CONTINUE );
+  }
+
+
+  void Session::onConsecutiveFrame( const BasicFrame &frame )
+  {
+    if ( mRxState != State::TRANSFERRING )
+    {
+      return;
+    }
+
+    const size_t chunk = std::min( CF_PAYLOAD, mRxLength - mRxOffset );
+    if ( ( ( frame.data[ 0 ] & 0x0F ) != mRxSN ) || ( frame.dataLength < ( 1 + chunk ) ) )
+    {
+      finishRx( Chimera::Status::FAIL );
+      return;
+    }
+
+    memcpy( mRxBuffer + mRxOffset, &frame.data[ 1 ], chunk );
+    mRxOffset += chunk;
+    mRxSN       = ( mRxSN + 1 ) & 0x0F;
+    mRxDeadline = Chimera::millis() + mConfig.timeout;
+
+    if ( mRxOffset >= mRxLength )
+    {
+      mFlowPending = false;
+      mRxResult    = Chimera::Status::OK;
+      mRxState     = State::COMPLETE;
+      return;
+    }
+
+    if ( mConfig.blockSize && ( ++mRxBlockCount >= mConfig.blockSize ) )
+    {
+      mRxBlockCount = 0;
+      mFlowPending  = !sendFlowControl( FC_CONTINUE );
+    }
+  }
+
+
+  void Session::onFlowControl( const BasicFrame &frame )
+  {
+    if ( ( mTxState != State::WAIT_FLOW_CONTROL ) || ( frame.dataLength < 3 ) )
+    {
+      return;
+    }
+
+    switch ( frame.data[ 0 ] & 0x0F )
+    {
+      case FC_CONTINUE:
+        mTxBlockLeft = frame.data[ 1 ];
+        mTxGapUs     = stMinToMicros( frame.data[ 2 ] );
+        mTxNextUs    = Chimera::micros();
+        mTxState     = State::TRANSFERRING;
+        pumpConsecutive();
+        break;
+
+      case FC_WAIT:
+        if ( ++mTxWaits > mConfig.maxWaits )
+        {
+          finishTx( Chimera::Status::TIMEOUT );
+        }
+        else
+        {
+          mTxDeadline = Chimera::millis() + mConfig.timeout;
+        }
+        break;
+
+      case FC_OVERFLOW:
+        finishTx( Chimera::Status::FULL );
+        break;
+
+      default:
+        finishTx( Chimera::Status::FAIL );
+        break;
+    }
+  }
+
+
+  void Session::pumpConsecutive()
+  {
+    while ( mTxState == State::TRANSFERRING )
+    {
+      if ( mTxGapUs && !reached( Chimera::micros(), mTxNextUs ) )
+      {
+        return;
+      }
+
+      /*-------------------------------------------------
+      With no STmin, hand the driver as many frames as
+      the block allows in one burst. Otherwise one frame
+      per gap.
+      -------------------------------------------------*/
+      size_t limit = mTxGapUs ? 1 : TX_BATCH;
+      if ( mTxBlockLeft )
+      {
+        limit = std::min<size_t>( limit, mTxBlockLeft );
+      }
+
+      BasicFrame batch[ TX_BATCH ];
+      size_t count  = 0;
+      size_t offset = mTxOffset;
+      uint8_t sn    = mTxSN;
+
+      while ( ( count < limit ) && ( offset < mTxLength ) )
+      {
+        const size_t chunk = std::min( CF_PAYLOAD, mTxLength - offset );
+        buildFrame( batch[ count ], 1 + chunk );
+        batch[ count ].data[ 0 ] = static_cast<uint8_t>( ( PCI_CONSECUTIVE << 4 ) | sn );
+        memcpy( &batch[ count ].data[ 1 ], mTxData + offset, chunk );
+
+        offset += chunk;
+        sn = ( sn + 1 ) & 0x0F;
+        count++;
+      }
+
+      const size_t sent = mDriver->sendBurst( batch, count );
+      if ( !sent )
+      {
+        return;
+      }
+
+      mTxOffset = std::min( mTxLength, mTxOffset + ( sent * CF_PAYLOAD ) );
+      mTxSN     = ( mTxSN + sent ) & 0x0F;
+      mTxNextUs = Chimera::micros() + mTxGapUs;
+
+      if ( mTxOffset >= mTxLength )
+      {
+        finishTx( Chimera::Status::OK );
+        return;
+      }
+
+      if ( mTxBlockLeft )
+      {
+        mTxBlockLeft -= static_cast<uint8_t>( sent );
+        if ( !mTxBlockLeft )
+        {
+          mTxWaits    = 0;
+          mTxDeadline = Chimera::millis() + mConfig.timeout;
+          mTxState    = State::WAIT_FLOW_CONTROL;
+          return;
+        }
+      }
+
+      /*-------------------------------------------------
+      The driver's TX buffer filled up. Pick up again on
+      the next poll.
+      -------------------------------------------------*/
+      if ( sent < count )
+      {
+        return;
+      }
+    }
+  }
+
+
+  bool Session::sendFlowControl( const uint8_t status )
+  {
+    BasicFrame frame;
+    buildFrame( frame, 3 );
+    frame.data[ 0 ] = static_cast<uint8_t>( ( PCI_FLOW_CONTROL << 4 ) | status );
+    frame.data[ 1 ] = mConfig.blockSize;
+    frame.data[ 2 ] = mConfig.stMin;
+
+    return mDriver->send( frame ) == Chimera::Status::OK;
+  }
+
+
+  void Session::buildFrame( BasicFrame &frame, const size_t length ) const
+  {
+    frame.clear();
+    frame.id         = mConfig.txId;
+    frame.idMode     = mConfig.idMode;
+    frame.frameType  = FrameType::DATA;
+    frame.dataLength = static_cast<DataLength_t>( mConfig.padFrames ? FRAME_SIZE : length );
+
+    if ( mConfig.padFrames )
+    {
+      memset( &frame.data[ length ], mConfig.padValue, FRAME_SIZE - length );
+    }
+  }
+
+
+  void Session::finishTx( const Chimera::Status_t result )
+  {
+    mTxData   = nullptr;
+    mTxResult = result;
+    mTxState  = ( result == Chimera::Status::OK ) ? State::IDLE : State::ERROR;
+  }
+
+
+  void Session::finishRx( const Chimera::Status_t result )
+  {
+    mFlowPending = false;
+    mRxResult    = result;
+    mRxState     = ( result == Chimera::Status::OK ) ? State::IDLE : State::ERROR;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Transport Implementation
+  -------------------------------------------------------------------------------*/
+  Transport::Transport() : mDriver( nullptr ), mUnhandled( nullptr )
+  {
+    mSessions.fill( nullptr );
+  }
+
+
+  Transport::~Transport()
+  {
+  }
+
+
+  Chimera::Status_t Transport::open( Driver_rPtr driver, FrameCallback_t unhandled )
+  {
+    if ( !driver )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    mDriver    = driver;
+    mUnhandled = unhandled;
+    return Chimera::Status::OK;
+  }
+
+
+  Chimera::Status_t Transport::attach( Session &session )
+  {
+    Session **slot = nullptr;
+
+    for ( auto &entry : mSessions )
+    {
+      if ( entry == &session )
+      {
+        return Chimera::Status::OK;
+      }
+      else if ( !entry && !slot )
+      {
+        slot = &entry;
+      }
+    }
+
+    if ( !slot )
+    {
+      return Chimera::Status::FULL;
+    }
+
+    *slot = &session;
+    return Chimera::Status::OK;
+  }
+
+
+  Chimera::Status_t Transport::detach( Session &session )
+  {
+    for ( auto &entry : mSessions )
+    {
+      if ( entry == &session )
+      {
+        entry = nullptr;
+        return Chimera::Status::OK;
+      }
+    }
+
+    return Chimera::Status::NOT_FOUND;
+  }
+
+
+  size_t Transport::process()
+  {
+    if ( !mDriver )
+    {
+      return 0;
+    }
+
+    /*-------------------------------------------------
+    Route everything waiting in the driver
+    -------------------------------------------------*/
+    size_t total = 0;
+    size_t count = 0;
+
+    do
+    {
+      count = mDriver->receiveBurst( mBatch.data(), mBatch.size() );
+      total += count;
+
+      for ( size_t idx = 0; idx < count; idx++ )
+      {
+        bool claimed = false;
+        for ( auto session : mSessions )
+        {
+          if ( session && session->handle( mBatch[ idx ] ) )
+          {
+            claimed = true;
+            break;
+          }
+        }
+
+        if ( !claimed && mUnhandled )
+        {
+          mUnhandled( &mBatch[ idx ] );
+        }
+      }
+    } while ( count == mBatch.size() );
+
+    /*-------------------------------------------------
+    Then let each session move its TX data and check
+    its timers
+    -------------------------------------------------*/
+    for ( auto session : mSessions )
+    {
+      if ( session )
+      {
+        session->poll();
+      }
+    }
+
+    return total;
+  }
+}  // namespace Chimera::CAN::ISOTP
@@ -0,0 +1,289 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_can_scheduler.cpp
+ *
+ *  Description:
+ *    Priority ordered TX queue for CAN frames
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/can>
+#include <Chimera/common>
+
+namespace Chimera::CAN
+{
+  /*-------------------------------------------------------------------------------
+  BasicTxScheduler Implementation
+  -------------------------------------------------------------------------------*/
+  template<typename T>
+  BasicTxScheduler<T>::BasicTxScheduler() : mBuffer( nullptr ), mCapacity( 0 )
+  {
+    clear();
+  }
+
+
+  template<typename T>
+  BasicTxScheduler<T>::~BasicTxScheduler()
+  {
+  }
+
+
+  template<typename T>
+  Chimera::Status_t BasicTxScheduler<T>::attach( T *const buffer, const size_t elements )
+  {
+    if ( !buffer || !elements )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    mBuffer   = buffer;
+    mCapacity = std::min<size_t>( elements, CHIMERA_CAN_TX_SCHEDULER_DEPTH );
+    clear();
+    return Chimera::Status::OK;
+  }
+
+
+  template<typename T>
+  void BasicTxScheduler<T>::clear()
+  {
+    mSize     = 0;
+    mBackSeq  = SEQ_START;
+    mFrontSeq = SEQ_START - 1;
+
+    /*-------------------------------------------------
+    Free list is a stack, so hand out low slots first
+    -------------------------------------------------*/
+    for ( size_t idx = 0; idx < mCapacity; idx++ )
+    {
+      mFree[ idx ] = static_cast<uint16_t>( mCapacity - 1 - idx );
+    }
+  }
+
+
+  template<typename T>
+  Chimera::Status_t BasicTxScheduler<T>::push( const T &frame, size_t *const slot )
+  {
+    if ( mBackSeq == UINT32_MAX )
+    {
+      renumber();
+    }
+
+    return insert( frame, mBackSeq++, slot );
+  }
+
+
+  template<typename T>
+  Chimera::Status_t BasicTxScheduler<T>::requeue( const T &frame, size_t *const slot )
+  {
+    if ( mFrontSeq == 0 )
+    {
+      renumber();
+    }
+
+    return insert( frame, mFrontSeq--, slot );
+  }
+
+
+  template<typename T>
+  bool BasicTxScheduler<T>::pop( T &frame, size_t *const slot )
+  {
+    if ( !mSize )
+    {
+      return false;
+    }
+
+    const uint16_t index = mHeap[ 0 ].slot;
+    frame                = mBuffer[ index ];
+
+    mFree[ mCapacity - mSize ] = index;
+
+    if ( slot )
+    {
+      *slot = index;
+    }
+
+    mSize--;
+    if ( mSize )
+    {
+      mHeap[ 0 ] = mHeap[ mSize ];
+      siftDown( 0 );
+    }
+
+    return true;
+  }
+
+
+  template<typename T>
+  const T *BasicTxScheduler<T>::top() const
+  {
+    return mSize ? &mBuffer[ mHeap[ 0 ].slot ] : nullptr;
+  }
+
+
+  template<typename T>
+  bool BasicTxScheduler<T>::preempts( const T &loaded ) const
+  {
+    return mSize && ( Util::arbitrationKey( mBuffer[ mHeap[ 0 ].slot ] ) < Util::arbitrationKey( loaded ) );
+  }
+
+
+  template<typename T>
+  size_t BasicTxScheduler<T>::preemptSlot( const T *const mailboxes, const size_t count ) const
+  {
+    if ( !mSize || !mailboxes )
+    {
+      return count;
+    }
+
+    const uint64_t best = Util::arbitrationKey( mBuffer[ mHeap[ 0 ].slot ] );
+    size_t victim       = count;
+    uint64_t worst      = best;
+
+    for ( size_t idx = 0; idx < count; idx++ )
+    {
+      const uint64_t key = Util::arbitrationKey( mailboxes[ idx ] );
+      if ( key > worst )
+      {
+        worst  = key;
+        victim = idx;
+      }
+    }
+
+    return victim;
+  }
+
+
+  template<typename T>
+  size_t BasicTxScheduler<T>::size() const
+  {
+    return mSize;
+  }
+
+
+  template<typename T>
+  size_t BasicTxScheduler<T>::capacity() const
+  {
+    return mCapacity;
+  }
+
+
+  template<typename T>
+  bool BasicTxScheduler<T>::empty() const
+  {
+    return mSize == 0;
+  }
+
+
+  template<typename T>
+  Chimera::Status_t BasicTxScheduler<T>::insert( const T &frame, const uint32_t seq, size_t *const slot )
+  {
+    if ( !mBuffer )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+    else if ( mSize >= mCapacity )
+    {
+      return Chimera::Status::FULL;
+    }
+
+    const uint16_t index = mFree[ mCapacity - 1 - mSize ];
+    mBuffer[ index ]     = frame;
+
+    if ( slot )
+    {
+      *slot = index;
+    }
+
+    mHeap[ mSize ].order = ( Util::arbitrationKey( frame ) << 32 ) | seq;
+    mHeap[ mSize ].slot  = index;
+    siftUp( mSize );
+    mSize++;
+
+    return Chimera::Status::OK;
+  }
+
+
+  template<typename T>
+  void BasicTxScheduler<T>::renumber()
+  {
+    /*-------------------------------------------------
+    A sequence counter ran out. Sort the pending frames
+    into their pop order, which is also a valid heap,
+    then reassign sequences around the midpoint.
+    -------------------------------------------------*/
+    std::sort( mHeap.begin(), mHeap.begin() + mSize,
+               []( const Entry &a, const Entry &b ) { return a.order < b.order; } );
+
+    mFrontSeq = SEQ_START - 1;
+    mBackSeq  = SEQ_START;
+
+    for ( size_t idx = 0; idx < mSize; idx++ )
+    {
+      mHeap[ idx ].order = ( mHeap[ idx ].order & 0xFFFFFFFF00000000ull ) | mBackSeq++;
+    }
+  }
+
+
+  template<typename T>
+  void BasicTxScheduler<T>::siftUp( size_t idx )
+  {
+    const Entry item = mHeap[ idx ];
+
+    while ( idx > 0 )
+    {
+      const size_t parent = ( idx - 1 ) / 2;
+      if ( mHeap[ parent ].order <= item.order )
+      {
+        break;
+      }
+
+      mHeap[ idx ] = mHeap[ parent ];
+      idx          = parent;
+    }
+
+    mHeap[ idx ] = item;
+  }
+
+
+  template<typename T>
+  void BasicTxScheduler<T>::siftDown( size_t idx )
+  {
+    const Entry item = mHeap[ idx ];
+
+    while ( true )
+    {
+      size_t child = ( 2 * idx ) + 1;
+      if ( child >= mSize )
+      {
+        break;
+      }
+
+      if ( ( ( child + 1 ) < mSize ) && ( mHeap[ child + 1 ].order < mHeap[ child ].order ) )
+      {
+        child++;
+      }
+
+      if ( item.order <= mHeap[ child ].order )
+      {
+        break;
+      }
+
+      mHeap[ idx ] = mHeap[ child ];
+      idx          = child;
+    }
+
+    mHeap[ idx ] = item;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Explicit Instantiations
+  -------------------------------------------------------------------------------*/
+  template class BasicTxScheduler<BasicFrame>;
+  template class BasicTxScheduler<FDFrame>;
+}  // namespace Chimera::CAN
@@ -0,0 +1,225 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_can_status.cpp
+ *
+ *  Description:
+ *    Bookkeeping behind CANStatus
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/can>
+#include <Chimera/common>
+
+namespace Chimera::CAN
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint16_t ERROR_PASSIVE_LIMIT = 127;
+  static constexpr uint16_t BUS_OFF_LIMIT       = 255;
+  static constexpr uint16_t TX_ERROR_PENALTY    = 8;
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  static inline uint64_t bitTimeNs( const size_t bits, const size_t baudRate )
+  {
+    return baudRate ? ( ( static_cast<uint64_t>( bits ) * 1000000000ull ) / baudRate ) : 0;
+  }
+
+  /*-------------------------------------------------------------------------------
+  StatusTracker Implementation
+  -------------------------------------------------------------------------------*/
+  StatusTracker::StatusTracker()
+  {
+    reset( 0, 0 );
+  }
+
+
+  StatusTracker::~StatusTracker()
+  {
+  }
+
+
+  void StatusTracker::reset( const size_t timestamp, const size_t baudRate, const size_t dataBaudRate )
+  {
+    mStatus.clear();
+    mBaudRate     = baudRate;
+    mDataBaudRate = dataBaudRate ? dataBaudRate : baudRate;
+    mStart        = timestamp;
+
+    mBusyNs.fill( 0 );
+    mEpoch.fill( NO_EPOCH );
+  }
+
+
+  void StatusTracker::clearCounters()
+  {
+    mStatus.txBuffer.highWater   = mStatus.txBuffer.pending;
+    mStatus.rxBuffer.highWater   = mStatus.rxBuffer.pending;
+    mStatus.fdTxBuffer.highWater = mStatus.fdTxBuffer.pending;
+    mStatus.fdRxBuffer.highWater = mStatus.fdRxBuffer.pending;
+
+    mStatus.txFrames        = 0;
+    mStatus.rxFrames        = 0;
+    mStatus.rxOverruns      = 0;
+    mStatus.txErrors        = 0;
+    mStatus.arbitrationLost = 0;
+  }
+
+
+  void StatusTracker::capacity( const BufferType type, const size_t elements, const bool fd )
+  {
+    buffer( type, fd ).capacity = elements;
+  }
+
+
+  void StatusTracker::level( const BufferType type, const size_t pending, const bool fd )
+  {
+    auto &buf   = buffer( type, fd );
+    buf.pending = pending;
+
+    if ( pending > buf.highWater )
+    {
+      buf.highWater = pending;
+    }
+  }
+
+
+  void StatusTracker::busy( const size_t timestamp, const size_t nominalBits, const size_t dataBits )
+  {
+    /*-------------------------------------------------
+    The whole frame lands in the bucket it ended in. A
+    bucket still holding an older epoch is recycled.
+    -------------------------------------------------*/
+    const size_t epoch = timestamp / BUCKET_US;
+    const size_t idx   = epoch % CHIMERA_CAN_STATUS_LOAD_BUCKETS;
+
+    if ( mEpoch[ idx ] != epoch )
+    {
+      mEpoch[ idx ]  = epoch;
+      mBusyNs[ idx ] = 0;
+    }
+
+    const uint64_t ns    = bitTimeNs( nominalBits, mBaudRate ) + bitTimeNs( dataBits, mDataBaudRate );
+    const uint64_t total = mBusyNs[ idx ] + ns;
+    mBusyNs[ idx ]       = ( total > UINT32_MAX ) ? UINT32_MAX : static_cast<uint32_t>( total );
+  }
+
+
+  void StatusTracker::transmitted( const size_t timestamp )
+  {
+    mStatus.txFrames++;
+    mStatus.lastTx = static_cast<uint32_t>( timestamp );
+
+    if ( mStatus.txErrorCount )
+    {
+      mStatus.txErrorCount--;
+    }
+  }
+
+
+  void StatusTracker::received( const size_t timestamp )
+  {
+    mStatus.rxFrames++;
+    mStatus.lastRx = static_cast<uint32_t>( timestamp );
+
+    if ( mStatus.rxErrorCount )
+    {
+      mStatus.rxErrorCount--;
+    }
+  }
+
+
+  void StatusTracker::overrun()
+  {
+    mStatus.rxOverruns++;
+  }
+
+
+  void StatusTracker::txError( const bool ackError )
+  {
+    mStatus.txErrors++;
+
+    /*-------------------------------------------------
+    An error passive transmitter that misses its ACK
+    isn't penalized, otherwise a node alone on the bus
+    would drive itself bus off.
+    -------------------------------------------------*/
+    if ( ackError && ( mStatus.txErrorCount > ERROR_PASSIVE_LIMIT ) )
+    {
+      return;
+    }
+
+    mStatus.txErrorCount += TX_ERROR_PENALTY;
+  }
+
+
+  void StatusTracker::lostArbitration( const size_t count )
+  {
+    mStatus.arbitrationLost += count;
+  }
+
+
+  void StatusTracker::errorCounters( const uint16_t tec, const uint16_t rec )
+  {
+    mStatus.txErrorCount = tec;
+    mStatus.rxErrorCount = rec;
+  }
+
+
+  CANStatus StatusTracker::snapshot( const size_t timestamp ) const
+  {
+    CANStatus status = mStatus;
+
+    status.errorPassive =
+        ( status.txErrorCount > ERROR_PASSIVE_LIMIT ) || ( status.rxErrorCount > ERROR_PASSIVE_LIMIT );
+    status.busOff = ( status.txErrorCount > BUS_OFF_LIMIT );
+
+    /*-------------------------------------------------
+    The window is the current partial bucket plus the
+    ones before it, trimmed to the time since reset.
+    -------------------------------------------------*/
+    const size_t current = timestamp / BUCKET_US;
+    uint64_t busyNs      = 0;
+
+    for ( size_t idx = 0; idx < CHIMERA_CAN_STATUS_LOAD_BUCKETS; idx++ )
+    {
+      const size_t epoch = mEpoch[ idx ];
+      if ( ( epoch != NO_EPOCH ) && ( epoch <= current ) && ( ( current - epoch ) < CHIMERA_CAN_STATUS_LOAD_BUCKETS ) )
+      {
+        busyNs += mBusyNs[ idx ];
+      }
+    }
+
+    size_t windowUs = ( ( CHIMERA_CAN_STATUS_LOAD_BUCKETS - 1 ) * BUCKET_US ) + ( timestamp % BUCKET_US );
+    if ( ( timestamp - mStart ) < windowUs )
+    {
+      windowUs = timestamp - mStart;
+    }
+
+    if ( windowUs )
+    {
+      const float load = ( static_cast<float>( busyNs ) * 0.1f ) / static_cast<float>( windowUs );
+      status.busLoad   = ( load > 100.0f ) ? 100.0f : load;
+    }
+
+    return status;
+  }
+
+
+  BufferStatus &StatusTracker::buffer( const BufferType type, const bool fd )
+  {
+    if ( type == BufferType::TX )
+    {
+      return fd ? mStatus.fdTxBuffer : mStatus.txBuffer;
+    }
+
+    return fd ? mStatus.fdRxBuffer : mStatus.rxBuffer;
+  }
+}  // namespace Chimera::CAN
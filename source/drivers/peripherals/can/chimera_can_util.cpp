@@ -0,0 +1,248 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_can_util.cpp
+ *
+ *  Description:
+ *    Frame level helpers shared by CAN backends
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/can>
+#include <Chimera/common>
+
+namespace Chimera::CAN::Util
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint16_t CRC15_POLY     = 0x4599;
+  static constexpr size_t TRAILING_BITS    = 13; /**< CRC delim, ACK slot/delim, EOF, IFS */
+  static constexpr size_t FD_TRAILING_BITS = 12; /**< ACK slot/delim, EOF, IFS */
+
+  /**
+   *  Payload length for each FD DLC code
+   */
+  static constexpr uint8_t FD_LENGTHS[ 16 ] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64 };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Tracks the length and CRC of the stuffed portion of a frame as bits are
+   *  appended in wire order
+   */
+  class BitCounter
+  {
+  public:
+    BitCounter() : mCRC( 0 ), mBits( 0 ), mRun( 0 ), mLast( 2 )
+    {
+    }
+
+    void push( const uint32_t value, const size_t width, const bool crc = true )
+    {
+      for ( size_t idx = width; idx > 0; idx-- )
+      {
+        const uint8_t bit = ( value >> ( idx - 1 ) ) & 1u;
+
+        if ( crc )
+        {
+          const uint8_t next = bit ^ ( ( mCRC >> 14 ) & 1u );
+          mCRC               = ( mCRC << 1 ) & 0x7FFF;
+          mCRC ^= next ? CRC15_POLY : 0;
+        }
+
+        stuff( bit );
+      }
+    }
+
+    uint16_t crc() const
+    {
+      return mCRC;
+    }
+
+    size_t bits() const
+    {
+      return mBits;
+    }
+
+  private:
+    uint16_t mCRC;
+    size_t mBits;
+    size_t mRun;
+    uint8_t mLast;
+
+    void stuff( const uint8_t bit )
+    {
+      mBits++;
+      mRun  = ( bit == mLast ) ? ( mRun + 1 ) : 1;
+      mLast = bit;
+
+      /*-------------------------------------------------
+      Five equal bits in a row force a complement bit,
+      which then starts the next run.
+      -------------------------------------------------*/
+      if ( mRun == 5 )
+      {
+        mBits++;
+        mLast = !mLast;
+        mRun  = 1;
+      }
+    }
+  };
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  static uint64_t keyFor( const Identifier_t id, const IdType mode, const uint64_t rtr )
+  {
+    /*-------------------------------------------------
+    Lay the arbitration field out in wire order, where
+    a 0 (dominant) bit wins:
+      Standard: base[11] RTR IDE=0
+      Extended: base[11] SRR=1 IDE=1 ext[18] RTR
+    -------------------------------------------------*/
+    if ( mode == IdType::EXTENDED )
+    {
+      const uint64_t full = id & ID_MASK_29_BIT;
+      const uint64_t base = full >> 18;
+      const uint64_t ext  = full & 0x3FFFF;
+      return ( base << 21 ) | ( 1ull << 20 ) | ( 1ull << 19 ) | ( ext << 1 ) | rtr;
+    }
+
+    const uint64_t base = id & ID_MASK_11_BIT;
+    return ( base << 21 ) | ( rtr << 20 );
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  uint64_t arbitrationKey( const BasicFrame &frame )
+  {
+    return keyFor( frame.id, frame.idMode, ( frame.frameType == FrameType::REMOTE ) ? 1u : 0u );
+  }
+
+
+  uint64_t arbitrationKey( const FDFrame &frame )
+  {
+    return keyFor( frame.id, frame.idMode, 0 );
+  }
+
+
+  size_t frameBits( const BasicFrame &frame )
+  {
+    const bool remote  = ( frame.frameType == FrameType::REMOTE );
+    const size_t bytes = ( frame.dataLength < MAX_PAYLOAD_LENGTH ) ? frame.dataLength : MAX_PAYLOAD_LENGTH;
+
+    BitCounter counter;
+    counter.push( 0, 1 ); /* SOF */
+
+    if ( frame.idMode == IdType::EXTENDED )
+    {
+      const uint32_t id = frame.id & ID_MASK_29_BIT;
+      counter.push( id >> 18, 11 );
+      counter.push( 0x3, 2 ); /* SRR, IDE */
+      counter.push( id & 0x3FFFF, 18 );
+      counter.push( remote, 1 );
+      counter.push( 0, 2 ); /* r1, r0 */
+    }
+    else
+    {
+      counter.push( frame.id & ID_MASK_11_BIT, 11 );
+      counter.push( remote, 1 );
+      counter.push( 0, 2 ); /* IDE, r0 */
+    }
+
+    counter.push( frame.dataLength & 0xF, 4 );
+
+    if ( !remote )
+    {
+      for ( size_t idx = 0; idx < bytes; idx++ )
+      {
+        counter.push( frame.data[ idx ], 8 );
+      }
+    }
+
+    counter.push( counter.crc(), 15, false );
+    return counter.bits() + TRAILING_BITS;
+  }
+
+
+  size_t frameBits( const FDFrame &frame, size_t &dataPhaseBits )
+  {
+    const size_t bytes = fdPaddedLength( frame.dataLength );
+
+    /*-------------------------------------------------
+    Arbitration phase, through BRS, at the nominal rate
+    -------------------------------------------------*/
+    BitCounter counter;
+    counter.push( 0, 1, false ); /* SOF */
+
+    if ( frame.idMode == IdType::EXTENDED )
+    {
+      const uint32_t id = frame.id & ID_MASK_29_BIT;
+      counter.push( id >> 18, 11, false );
+      counter.push( 0x3, 2, false ); /* SRR, IDE */
+      counter.push( id & 0x3FFFF, 18, false );
+      counter.push( 0x2, 3, false ); /* RRS, FDF, res */
+    }
+    else
+    {
+      counter.push( frame.id & ID_MASK_11_BIT, 11, false );
+      counter.push( 0x2, 4, false ); /* RRS, IDE, FDF, res */
+    }
+
+    counter.push( frame.bitRateSwitch, 1, false );
+    const size_t nominal = counter.bits();
+
+    /*-------------------------------------------------
+    Data phase. Dynamic stuffing ends with the data
+    field; the stuff count and CRC use fixed stuff bits
+    instead: 6 around a CRC-17, 7 around a CRC-21.
+    -------------------------------------------------*/
+    counter.push( frame.errorPassive, 1, false );
+    counter.push( fdDLC( bytes ), 4, false );
+
+    for ( size_t idx = 0; idx < bytes; idx++ )
+    {
+      counter.push( frame.data[ idx ], 8, false );
+    }
+
+    const bool longCRC   = ( bytes > 16 );
+    const size_t crcBits = longCRC ? 21 : 17;
+    const size_t fixed   = longCRC ? 7 : 6;
+
+    dataPhaseBits = ( counter.bits() - nominal ) + 4 + crcBits + fixed + 1;
+    return nominal + FD_TRAILING_BITS;
+  }
+
+
+  size_t fdLength( const uint8_t dlc )
+  {
+    return FD_LENGTHS[ dlc & 0x0F ];
+  }
+
+
+  uint8_t fdDLC( const size_t length )
+  {
+    for ( uint8_t dlc = 0; dlc < 16; dlc++ )
+    {
+      if ( FD_LENGTHS[ dlc ] >= length )
+      {
+        return dlc;
+      }
+    }
+
+    return 15;
+  }
+
+
+  size_t fdPaddedLength( const size_t length )
+  {
+    return FD_LENGTHS[ fdDLC( length ) ];
+  }
+}  // namespace Chimera::CAN::Util
@@ -0,0 +1,539 @@
+/********************************************************************************
+ *  File Name:
+ *    can_log.cpp
+ *
+ *  Description:
+ *    High rate binary CAN traffic logger for Linux hosts
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#if defined( __linux__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif /* __linux__ */
+
+/* STL Includes */
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/can/log/can_log.hpp>
+
+#if defined( __linux__ )
+
+namespace Chimera::CAN::Log
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr char MAGIC[ 8 ]        = { 'C', 'H', 'C', 'A', 'N', 'L', 'O', 'G' };
+  static constexpr size_t EXPORT_BATCH    = 256;
+  static constexpr size_t CANDUMP_MAX_LEN = 64;
+  static constexpr int64_t CLOCK_WRAP_US  = 1ll << 32; /**< Period of a 32-bit microsecond RX timestamp */
+
+  static_assert( ( CHIMERA_CAN_LOG_CHUNK_BYTES % 4096 ) == 0 );
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  static inline uint64_t wallClockUs()
+  {
+    using namespace std::chrono;
+    return static_cast<uint64_t>( duration_cast<microseconds>( system_clock::now().time_since_epoch() ).count() );
+  }
+
+
+  /**
+   *  Backs a region of the file with real blocks so that running out of disk
+   *  is reported here instead of as a SIGBUS when the mapping is written.
+   *  File systems that can't preallocate fall back to a sparse extension.
+   */
+  static bool reserve( const int file, const size_t offset, const size_t length )
+  {
+    const int result = posix_fallocate( file, static_cast<off_t>( offset ), static_cast<off_t>( length ) );
+    if ( result == 0 )
+    {
+      return true;
+    }
+    else if ( ( result == EOPNOTSUPP ) || ( result == EINVAL ) )
+    {
+      return ftruncate( file, static_cast<off_t>( offset + length ) ) == 0;
+    }
+
+    return false;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Logger Implementation
+  -------------------------------------------------------------------------------*/
+  Logger::Logger() :
+      mOpen( false ), mRunning( false ), mInFlight( 0 ), mLogged( 0 ), mDropped( 0 ), mWritten( 0 ),
+      mClockSynced( false ), mClockOffset( 0 ), mFile( -1 ), mMap( nullptr ), mMapSize( 0 ), mOffset( 0 )
+  {
+  }
+
+
+  Logger::~Logger()
+  {
+    close();
+  }
+
+
+  Chimera::Status_t Logger::open( const char *const path )
+  {
+    if ( !path )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+    else if ( mOpen )
+    {
+      return Chimera::Status::BUSY;
+    }
+
+    /*-------------------------------------------------
+    Create the file and map its first chunk
+    -------------------------------------------------*/
+    mFile = ::open( path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+    if ( mFile < 0 )
+    {
+      return Chimera::Status::FAILED_OPEN;
+    }
+
+    void *map = MAP_FAILED;
+    if ( reserve( mFile, 0, CHIMERA_CAN_LOG_CHUNK_BYTES ) )
+    {
+      map = mmap( nullptr, CHIMERA_CAN_LOG_CHUNK_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, mFile, 0 );
+    }
+
+    if ( map == MAP_FAILED )
+    {
+      ::close( mFile );
+      mFile = -1;
+      return Chimera::Status::FAILED_OPEN;
+    }
+
+    mMap     = static_cast<uint8_t *>( map );
+    mMapSize = CHIMERA_CAN_LOG_CHUNK_BYTES;
+
+    FileHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, MAGIC, sizeof( header.magic ) );
+    header.version    = FORMAT_VERSION;
+    header.recordSize = sizeof( Record );
+    header.startTime  = wallClockUs();
+
+    memcpy( mMap, &header, sizeof( header ) );
+    mOffset = sizeof( header );
+
+    /*-------------------------------------------------
+    Start accepting frames
+    -------------------------------------------------*/
+    mQueue.clear();
+    mLogged.store( 0 );
+    mDropped.store( 0 );
+    mWritten.store( 0 );
+    mClockSynced.store( false );
+    mClockOffset.store( 0 );
+
+    mRunning.store( true );
+    mWriter = std::thread( &Logger::run, this );
+    mOpen.store( true, std::memory_order_release );
+
+    return Chimera::Status::OK;
+  }
+
+
+  Chimera::Status_t Logger::close()
+  {
+    if ( !mOpen.exchange( false ) )
+    {
+      return Chimera::Status::OK;
+    }
+
+    /*-------------------------------------------------
+    Let log() calls that already saw the logger open
+    finish, so their records make the final drain
+    -------------------------------------------------*/
+    while ( mInFlight.load() )
+    {
+      std::this_thread::yield();
+    }
+
+    /*-------------------------------------------------
+    The writer drains the ring once more before exiting
+    -------------------------------------------------*/
+    mRunning.store( false );
+    mWriter.join();
+
+    /*-------------------------------------------------
+    Anything still queued couldn't be fit in the file
+    -------------------------------------------------*/
+    Record discard;
+    size_t lost = 0;
+
+    while ( mQueue.pop( discard ) )
+    {
+      lost++;
+    }
+
+    if ( lost )
+    {
+      mLogged.fetch_sub( lost, std::memory_order_relaxed );
+      mDropped.fetch_add( lost, std::memory_order_relaxed );
+    }
+
+    bool ok = ( msync( mMap, mOffset, MS_SYNC ) == 0 );
+    ok &= ( munmap( mMap, mMapSize ) == 0 );
+    ok &= ( ftruncate( mFile, static_cast<off_t>( mOffset ) ) == 0 );
+    ok &= ( ::close( mFile ) == 0 );
+
+    mMap     = nullptr;
+    mMapSize = 0;
+    mFile    = -1;
+
+    return ok ? Chimera::Status::OK : Chimera::Status::FAILED_CLOSE;
+  }
+
+
+  bool Logger::log( const uint8_t channel, const BasicFrame &frame )
+  {
+    if ( !enter() )
+    {
+      return false;
+    }
+
+    const bool queued = push( channel, frame, wallClockUs() );
+    leave();
+    return queued;
+  }
+
+
+  bool Logger::log( const uint8_t channel, const BasicFrame &frame, const uint32_t rxTimestamp )
+  {
+    if ( !enter() )
+    {
+      return false;
+    }
+
+    if ( !mClockSynced.load( std::memory_order_acquire ) )
+    {
+      syncClock( rxTimestamp );
+    }
+
+    const bool queued = push( channel, frame, toWallClock( rxTimestamp, wallClockUs() ) );
+    leave();
+    return queued;
+  }
+
+
+  size_t Logger::log( const uint8_t channel, const BasicFrame *const frames, const size_t count )
+  {
+    if ( !frames || !enter() )
+    {
+      return 0;
+    }
+
+    /*-------------------------------------------------
+    Stop at the first miss so the file never has gaps
+    in the middle of a batch
+    -------------------------------------------------*/
+    const uint64_t timestamp = wallClockUs();
+    size_t queued            = 0;
+
+    while ( ( queued < count ) && push( channel, frames[ queued ], timestamp ) )
+    {
+      queued++;
+    }
+
+    if ( queued < count )
+    {
+      mDropped.fetch_add( count - queued - 1, std::memory_order_relaxed );
+    }
+
+    leave();
+    return queued;
+  }
+
+
+  void Logger::syncClock( const uint32_t now )
+  {
+    mClockOffset.store( wallClockUs() - now, std::memory_order_relaxed );
+    mClockSynced.store( true, std::memory_order_release );
+  }
+
+
+  LogStats Logger::stats() const
+  {
+    LogStats result;
+    result.logged  = mLogged.load( std::memory_order_relaxed );
+    result.dropped = mDropped.load( std::memory_order_relaxed );
+    result.written = mWritten.load( std::memory_order_relaxed );
+    return result;
+  }
+
+
+  bool Logger::enter()
+  {
+    /*-------------------------------------------------
+    Register before checking, so close() either sees
+    this call in flight or this call sees it closed
+    -------------------------------------------------*/
+    mInFlight.fetch_add( 1 );
+    if ( !mOpen.load() )
+    {
+      leave();
+      return false;
+    }
+
+    return true;
+  }
+
+
+  void Logger::leave()
+  {
+    mInFlight.fetch_sub( 1 );
+  }
+
+
+  uint64_t Logger::toWallClock( const uint32_t rxTimestamp, const uint64_t now ) const
+  {
+    /*-------------------------------------------------
+    The RX clock wraps every ~71 minutes. Frames are
+    logged soon after they arrive, so pick the wrap
+    that lands closest to the current time.
+    -------------------------------------------------*/
+    const uint64_t wall = mClockOffset.load( std::memory_order_relaxed ) + rxTimestamp;
+    const int64_t diff  = static_cast<int64_t>( now - wall );
+    const int64_t half  = CLOCK_WRAP_US / 2;
+    const int64_t wraps = ( diff + ( ( diff >= 0 ) ? half : -half ) ) / CLOCK_WRAP_US;
+
+    return wall + static_cast<uint64_t>( wraps * CLOCK_WRAP_US );
+  }
+
+
+  bool Logger::push( const uint8_t channel, const BasicFrame &frame, const uint64_t timestamp )
+  {
+    Record record;
+    record.timestamp = timestamp;
+    record.length    = ( frame.dataLength > MAX_PAYLOAD_LENGTH ) ? MAX_PAYLOAD_LENGTH : frame.dataLength;
+    record.channel   = channel;
+    record.flags     = RECORD_VALID;
+    record.reserved  = 0;
+
+    if ( frame.idMode == IdType::EXTENDED )
+    {
+      record.canId = ( frame.id & ID_MASK_29_BIT ) | CAN_EFF_FLAG;
+    }
+    else
+    {
+      record.canId = frame.id & ID_MASK_11_BIT;
+    }
+
+    if ( frame.frameType == FrameType::REMOTE )
+    {
+      record.canId |= CAN_RTR_FLAG;
+    }
+
+    memcpy( record.data, frame.data, MAX_PAYLOAD_LENGTH );
+    memset( record.data + record.length, 0, MAX_PAYLOAD_LENGTH - record.length );
+
+    if ( !mQueue.push( record ) )
+    {
+      mDropped.fetch_add( 1, std::memory_order_relaxed );
+      return false;
+    }
+
+    mLogged.fetch_add( 1, std::memory_order_relaxed );
+    return true;
+  }
+
+
+  void Logger::run()
+  {
+    while ( mRunning.load( std::memory_order_acquire ) )
+    {
+      if ( !drain() )
+      {
+        std::this_thread::sleep_for( std::chrono::milliseconds( CHIMERA_CAN_LOG_IDLE_PERIOD_MS ) );
+      }
+    }
+
+    drain();
+  }
+
+
+  size_t Logger::drain()
+  {
+    /*-------------------------------------------------
+    Pop straight into the mapping, no staging copy
+    -------------------------------------------------*/
+    size_t count = 0;
+
+    while ( true )
+    {
+      if ( ( ( mOffset + sizeof( Record ) ) > mMapSize ) && !grow() )
+      {
+        break;
+      }
+
+      if ( !mQueue.pop( *reinterpret_cast<Record *>( mMap + mOffset ) ) )
+      {
+        break;
+      }
+
+      mOffset += sizeof( Record );
+      count++;
+    }
+
+    if ( count )
+    {
+      mWritten.fetch_add( count, std::memory_order_relaxed );
+    }
+
+    return count;
+  }
+
+
+  bool Logger::grow()
+  {
+    const size_t size = mMapSize + CHIMERA_CAN_LOG_CHUNK_BYTES;
+    if ( !reserve( mFile, mMapSize, CHIMERA_CAN_LOG_CHUNK_BYTES ) )
+    {
+      return false;
+    }
+
+    void *map = mremap( mMap, mMapSize, size, MREMAP_MAYMOVE );
+    if ( map == MAP_FAILED )
+    {
+      return false;
+    }
+
+    mMap     = static_cast<uint8_t *>( map );
+    mMapSize = size;
+    return true;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  size_t formatCandump( const Record &record, char *const buffer, const size_t size )
+  {
+    if ( !buffer || !size || !( record.flags & RECORD_VALID ) || ( record.length > MAX_PAYLOAD_LENGTH ) )
+    {
+      return 0;
+    }
+
+    const bool extended = ( record.canId & CAN_EFF_FLAG );
+    const uint32_t id   = record.canId & ( extended ? ID_MASK_29_BIT : ID_MASK_11_BIT );
+
+    char line[ CANDUMP_MAX_LEN ];
+    int length = snprintf( line, sizeof( line ), "(%" PRIu64 ".%06" PRIu64 ") can%u %0*" PRIX32 "#",
+                           record.timestamp / 1000000, record.timestamp % 1000000, record.channel,
+                           extended ? 8 : 3, id );
+
+    if ( record.canId & CAN_RTR_FLAG )
+    {
+      line[ length++ ] = 'R';
+    }
+    else
+    {
+      static constexpr char HEX[] = "0123456789ABCDEF";
+      for ( size_t idx = 0; idx < record.length; idx++ )
+      {
+        line[ length++ ] = HEX[ record.data[ idx ] >> 4 ];
+        line[ length++ ] = HEX[ record.data[ idx ] & 0x0F ];
+      }
+    }
+
+    line[ length++ ] = '\n';
+
+    if ( static_cast<size_t>( length ) >= size )
+    {
+      buffer[ 0 ] = '\0';
+      return 0;
+    }
+
+    memcpy( buffer, line, length );
+    buffer[ length ] = '\0';
+    return static_cast<size_t>( length );
+  }
+
+
+  Chimera::Status_t exportCandump( const char *const logPath, const char *const outPath )
+  {
+    if ( !logPath || !outPath )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    FILE *input = fopen( logPath, "rb" );
+    if ( !input )
+    {
+      return Chimera::Status::FAILED_OPEN;
+    }
+
+    FileHeader header;
+    if ( ( fread( &header, sizeof( header ), 1, input ) != 1 ) || memcmp( header.magic, MAGIC, sizeof( MAGIC ) ) ||
+         ( header.version != FORMAT_VERSION ) || ( header.recordSize != sizeof( Record ) ) )
+    {
+      fclose( input );
+      return Chimera::Status::FAILED_READ;
+    }
+
+    FILE *output = fopen( outPath, "w" );
+    if ( !output )
+    {
+      fclose( input );
+      return Chimera::Status::FAILED_OPEN;
+    }
+
+    /*-------------------------------------------------
+    A log from a process that died before close() ends
+    in preallocated space, which reads as invalid.
+    -------------------------------------------------*/
+    std::array<Record, EXPORT_BATCH> batch;
+    char line[ CANDUMP_MAX_LEN ];
+    auto result = Chimera::Status::OK;
+    bool done   = false;
+
+    while ( !done )
+    {
+      const size_t count = fread( batch.data(), sizeof( Record ), batch.size(), input );
+      done               = ( count < batch.size() );
+
+      for ( size_t idx = 0; idx < count; idx++ )
+      {
+        const size_t length = formatCandump( batch[ idx ], line, sizeof( line ) );
+        if ( !length )
+        {
+          done = true;
+          break;
+        }
+
+        if ( fwrite( line, 1, length, output ) != length )
+        {
+          result = Chimera::Status::FAILED_WRITE;
+          done   = true;
+          break;
+        }
+      }
+    }
+
+    fclose( input );
+    if ( fclose( output ) != 0 )
+    {
+      result = Chimera::Status::FAILED_WRITE;
+    }
+
+    return result;
+  }
+}  // namespace Chimera::CAN::Log
+
+#endif /* __linux__ */
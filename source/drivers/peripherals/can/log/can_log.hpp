@@ -0,0 +1,256 @@
+/********************************************************************************
+ *  File Name:
+ *    can_log.hpp
+ *
+ *  Description:
+ *    High rate binary CAN traffic logger for Linux hosts. Producers copy frames
+ *    into a lock-free ring and a writer thread appends them to a memory-mapped
+ *    file, one fixed size record per frame. Records carry everything a candump
+ *    log line does, see exportCandump().
+ *
+ *    Link chimera_peripheral_can_log. Only available on Linux.
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CAN_LOG_HPP
+#define CHIMERA_CAN_LOG_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <cstdint>
+
+#if defined( __linux__ )
+#include <atomic>
+#include <thread>
+#endif /* __linux__ */
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/container/lockfree_queue.hpp>
+#include <Chimera/source/drivers/peripherals/can/can_types.hpp>
+
+/*-------------------------------------------------------------------------------
+Literals
+-------------------------------------------------------------------------------*/
+/**
+ *  Frames the ring between producers and the writer thread can hold. Must be
+ *  a power of two. Size it for the worst burst that can arrive in
+ *  CHIMERA_CAN_LOG_IDLE_PERIOD_MS: a saturated 1 Mbit/s channel carries
+ *  roughly 9 frames per millisecond.
+ */
+#ifndef CHIMERA_CAN_LOG_QUEUE_DEPTH
+#define CHIMERA_CAN_LOG_QUEUE_DEPTH ( 8192 )
+#endif
+
+/**
+ *  Bytes the log file grows by each time the mapping fills. Must be a
+ *  multiple of the page size.
+ */
+#ifndef CHIMERA_CAN_LOG_CHUNK_BYTES
+#define CHIMERA_CAN_LOG_CHUNK_BYTES ( 4 * 1024 * 1024 )
+#endif
+
+/**
+ *  How long the writer thread sleeps after finding the ring empty
+ */
+#ifndef CHIMERA_CAN_LOG_IDLE_PERIOD_MS
+#define CHIMERA_CAN_LOG_IDLE_PERIOD_MS ( 5 )
+#endif
+
+#if defined( __linux__ )
+
+namespace Chimera::CAN::Log
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint16_t FORMAT_VERSION = 1;
+
+  /*-------------------------------------------------
+  Record::canId uses the SocketCAN can_id encoding
+  -------------------------------------------------*/
+  static constexpr uint32_t CAN_EFF_FLAG = 0x80000000; /**< Extended frame */
+  static constexpr uint32_t CAN_RTR_FLAG = 0x40000000; /**< Remote frame */
+
+  /*-------------------------------------------------
+  Record::flags
+  -------------------------------------------------*/
+  static constexpr uint8_t RECORD_VALID = 0x01; /**< Set in every written record, clear in unused file space */
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Start of every log file
+   */
+  struct FileHeader
+  {
+    char magic[ 8 ];     /**< "CHCANLOG" */
+    uint16_t version;    /**< FORMAT_VERSION */
+    uint16_t recordSize; /**< sizeof( Record ) */
+    uint32_t reserved;
+    uint64_t startTime; /**< Microseconds since the Unix epoch when the file was opened */
+  };
+  static_assert( sizeof( FileHeader ) == 24 );
+
+
+  /**
+   *  One logged frame. Records follow the header back to back.
+   */
+  struct Record
+  {
+    uint64_t timestamp;                 /**< Microseconds since the Unix epoch when the frame arrived or was logged */
+    uint32_t canId;                     /**< Identifier plus CAN_EFF_FLAG / CAN_RTR_FLAG */
+    uint8_t length;                     /**< Data length */
+    uint8_t channel;                    /**< Caller assigned channel number, printed as canN */
+    uint8_t flags;                      /**< RECORD_VALID */
+    uint8_t reserved;
+    uint8_t data[ MAX_PAYLOAD_LENGTH ]; /**< Payload, unused bytes zeroed */
+  };
+  static_assert( sizeof( Record ) == 24 );
+
+
+  struct LogStats
+  {
+    size_t logged;  /**< Frames accepted into the ring. Matches written once closed. */
+    size_t dropped; /**< Frames lost because the ring was full */
+    size_t written; /**< Frames in the file */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Logs frames from any number of threads to one file. log() never blocks
+   *  or touches the file, so it is safe to call straight from an RX path.
+   *  The file is preallocated in CHIMERA_CAN_LOG_CHUNK_BYTES steps and
+   *  trimmed to the last record on close().
+   *
+   *  The ring is embedded in the object, so give the logger static storage
+   *  or allocate it on the heap.
+   */
+  class Logger
+  {
+  public:
+    Logger();
+    ~Logger();
+
+    /**
+     *  Creates or truncates the log file and starts the writer thread
+     *
+     *  @param[in]  path          File to log into
+     *  @return Chimera::Status_t FAILED_OPEN if the file can't be created or mapped
+     */
+    Chimera::Status_t open( const char *const path );
+
+    /**
+     *  Writes out everything still in the ring, trims the file and stops
+     *  the writer thread
+     *
+     *  @return Chimera::Status_t
+     */
+    Chimera::Status_t close();
+
+    /**
+     *  Queues a frame for logging, stamped with the current time
+     *
+     *  @param[in]  channel       Channel number to record
+     *  @param[in]  frame         Frame to log
+     *  @return bool              False if the logger isn't open or the ring is full
+     */
+    bool log( const uint8_t channel, const BasicFrame &frame );
+
+    /**
+     *  Queues a frame for logging, stamped with when it arrived. The RX
+     *  timestamp is mapped onto the wall clock through the offset set by
+     *  syncClock(). If the clock wasn't synced since open(), the first frame
+     *  logged this way is taken to have just arrived.
+     *
+     *  @param[in]  channel       Channel number to record
+     *  @param[in]  frame         Frame to log
+     *  @param[in]  rxTimestamp   Microsecond RX timestamp from Driver::receive()
+     *  @return bool              False if the logger isn't open or the ring is full
+     */
+    bool log( const uint8_t channel, const BasicFrame &frame, const uint32_t rxTimestamp );
+
+    /**
+     *  Queues a batch of frames, all stamped with the same time
+     *
+     *  @param[in]  channel       Channel number to record
+     *  @param[in]  frames        Frames to log
+     *  @param[in]  count         Number of frames
+     *  @return size_t            Number of frames queued
+     */
+    size_t log( const uint8_t channel, const BasicFrame *const frames, const size_t count );
+
+    /**
+     *  Pairs the driver's microsecond clock with the wall clock. open() clears
+     *  the pairing, so call this after opening, and again now and then if the
+     *  two drift apart.
+     *
+     *  @param[in]  now           Current time on the clock RX timestamps are taken from
+     *  @return void
+     */
+    void syncClock( const uint32_t now );
+
+    /**
+     *  @return LogStats          Counters since open()
+     */
+    LogStats stats() const;
+
+  private:
+    using RecordQueue = Chimera::Container::MPSCQueue<Record, CHIMERA_CAN_LOG_QUEUE_DEPTH>;
+
+    std::atomic<bool> mOpen;
+    std::atomic<bool> mRunning;
+    std::atomic<size_t> mInFlight; /**< log() calls between enter() and leave() */
+    std::atomic<size_t> mLogged;
+    std::atomic<size_t> mDropped;
+    std::atomic<size_t> mWritten;
+    std::atomic<bool> mClockSynced;
+    std::atomic<uint64_t> mClockOffset; /**< Wall clock minus the driver clock, in microseconds */
+    std::thread mWriter;
+    RecordQueue mQueue;
+
+    int mFile;
+    uint8_t *mMap;
+    size_t mMapSize;
+    size_t mOffset; /**< Byte offset of the next record in the file */
+
+    bool enter();
+    void leave();
+    bool push( const uint8_t channel, const BasicFrame &frame, const uint64_t timestamp );
+    uint64_t toWallClock( const uint32_t rxTimestamp, const uint64_t now ) const;
+    void run();
+    size_t drain();
+    bool grow();
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Formats a record as a candump log line, eg "(1617123456.000123) can0 123#DEADBEEF\n"
+   *
+   *  @param[in]  record        Record to format
+   *  @param[out] buffer        Where to write the line, always null terminated
+   *  @param[in]  size          Size of the buffer. 64 bytes fits any record.
+   *  @return size_t            Length of the line, 0 if the record is invalid or the buffer too small
+   */
+  size_t formatCandump( const Record &record, char *const buffer, const size_t size );
+
+  /**
+   *  Converts a binary log into a candump log file that can-utils (canplayer,
+   *  log2asc, ...) reads
+   *
+   *  @param[in]  logPath       Binary log written by a Logger
+   *  @param[in]  outPath       candump log to create
+   *  @return Chimera::Status_t FAILED_READ if the log is malformed
+   */
+  Chimera::Status_t exportCandump( const char *const logPath, const char *const outPath );
+}  // namespace Chimera::CAN::Log
+
+#endif /* __linux__ */
+#endif /* !CHIMERA_CAN_LOG_HPP */
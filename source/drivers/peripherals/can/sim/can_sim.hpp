@@ -0,0 +1,104 @@
+/********************************************************************************
+ *  File Name:
+ *    can_sim.hpp
+ *
+ *  Description:
+ *    Host simulation backend for the Chimera CAN driver. Every opened Channel
+ *    attaches to one shared in-process virtual bus that arbitrates between
+ *    pending frames by ID and takes as long to move each frame as real
+ *    hardware would at the configured baud rate.
+ *
+ *    Link chimera_peripheral_can_sim in place of a hardware backend. Only
+ *    available when building with native threads.
+ *
+ *    A Driver binds to its simulated node when open() succeeds, using the
+ *    channel named in the config, so drivers from getDriver() and ones
+ *    constructed directly behave the same. Until then every call returns
+ *    NOT_READY, or zero/false/nothing where there is no status. That includes
+ *    the Lockable methods, so open a driver before locking it.
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CAN_SIM_HPP
+#define CHIMERA_CAN_SIM_HPP
+
+/* STL Includes */
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/can/can_types.hpp>
+
+namespace Chimera::CAN::Sim
+{
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  struct BusConfig
+  {
+    bool realTime; /**< Pace frames to the wall clock. If false, bus time only advances while frames move. */
+    bool oneShot;  /**< Drop frames that miss their ACK instead of retransmitting them, like bxCAN's NART */
+
+    void clear()
+    {
+      realTime = true;
+      oneShot  = false;
+    }
+  };
+
+
+  /**
+   *  Bus level measurements, all in simulated time
+   */
+  struct BusStats
+  {
+    size_t frames;           /**< Frames that completed transmission */
+    size_t bits;             /**< Bits those frames occupied, including stuffing */
+    size_t arbitrationLost;  /**< Times a pending frame lost arbitration to another node */
+    size_t ackErrors;        /**< Transmissions no other node acknowledged */
+    uint64_t busyNs;         /**< Time the bus spent transmitting */
+    uint64_t elapsedNs;      /**< Time since the stats were reset */
+    uint64_t totalLatencyNs; /**< Sum of send() to end of frame delays */
+    uint64_t maxLatencyNs;   /**< Worst send() to end of frame delay */
+
+    void clear()
+    {
+      frames          = 0;
+      bits            = 0;
+      arbitrationLost = 0;
+      ackErrors       = 0;
+      busyNs          = 0;
+      elapsedNs       = 0;
+      totalLatencyNs  = 0;
+      maxLatencyNs    = 0;
+    }
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Sets the behavior of the virtual bus
+   *
+   *  @param[in]  cfg           Bus settings
+   *  @return Chimera::Status_t
+   */
+  Chimera::Status_t configureBus( const BusConfig &cfg );
+
+  /**
+   *  Gets a snapshot of the bus measurements
+   *  @return BusStats
+   */
+  BusStats getBusStats();
+
+  /**
+   *  Zeroes the bus measurements
+   *  @return void
+   */
+  void resetBusStats();
+}  // namespace Chimera::CAN::Sim
+
+#endif /* !CHIMERA_CAN_SIM_HPP */
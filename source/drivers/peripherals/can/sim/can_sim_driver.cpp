@@ -0,0 +1,1346 @@
+/********************************************************************************
+ *  File Name:
+ *    can_sim_driver.cpp
+ *
+ *  Description:
+ *    Host simulation backend for the Chimera CAN driver
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Chimera Includes */
+#include <Chimera/can>
+#include <Chimera/common>
+#include <Chimera/event>
+#include <Chimera/thread>
+#include <Chimera/source/drivers/peripherals/can/sim/can_sim.hpp>
+
+#if defined( USING_NATIVE_THREADS )
+
+namespace Chimera::CAN::Sim
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t NUM_CHANNELS = EnumValue( Channel::NUM_OPTIONS );
+  static constexpr size_t NUM_TRIGGERS = EnumValue( Chimera::Event::Trigger::NUM_OPTIONS );
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Circular queue over a user supplied frame buffer
+   */
+  template<typename T>
+  struct FrameRing
+  {
+    T *buffer;
+    size_t size;
+    size_t head;
+    size_t count;
+
+    void attach( T *const data, const size_t elements )
+    {
+      buffer = data;
+      size   = elements;
+      clear();
+    }
+
+    void clear()
+    {
+      head  = 0;
+      count = 0;
+    }
+
+    bool push( const T &frame, size_t *const slot = nullptr )
+    {
+      if ( count >= size )
+      {
+        return false;
+      }
+
+      const size_t index = ( head + count ) % size;
+      buffer[ index ]    = frame;
+      count++;
+
+      if ( slot )
+      {
+        *slot = index;
+      }
+
+      return true;
+    }
+
+    bool pop( T &frame, size_t *const slot = nullptr )
+    {
+      if ( !count )
+      {
+        return false;
+      }
+
+      if ( slot )
+      {
+        *slot = head;
+      }
+
+      frame = buffer[ head ];
+      head  = ( head + 1 ) % size;
+      count--;
+      return true;
+    }
+  };
+
+
+  /**
+   *  One node on the virtual bus. All state other than the listeners is
+   *  guarded by the bus lock.
+   */
+  class SimCAN
+  {
+  public:
+    Chimera::Thread::RecursiveTimedMutex mMutex;
+
+    bool mOpen;
+    HardwareInit mInit;
+    TxScheduler mTx;
+    FrameRing<BasicFrame> mRx;
+    FDTxScheduler mFdTx;
+    FrameRing<FDFrame> mFdRx;
+    std::vector<uint64_t> mTxStamp;   /**< Bus time each queued TX frame was sent, indexed by buffer slot */
+    std::vector<uint64_t> mFdTxStamp; /**< Same for the FD TX buffer */
+    std::vector<uint32_t> mRxStamp;   /**< Microseconds each RX frame arrived, indexed by buffer slot */
+    std::vector<uint32_t> mFdRxStamp; /**< Same for the FD RX buffer */
+    bool mTxInFlight;                 /**< A classic frame is on the wire and still holds its TX buffer slot */
+    bool mFdTxInFlight;               /**< Same for an FD frame */
+    SoftwareFilter mFilter;
+    StatusTracker mStatus;
+    std::array<size_t, NUM_TRIGGERS> mEvents;
+
+    std::recursive_mutex mListenerLock;
+    Chimera::Event::ActionableList mListeners;
+    size_t mNextListenerId;
+
+    SimCAN() : mOpen( false ), mTxInFlight( false ), mFdTxInFlight( false ), mNextListenerId( 0 )
+    {
+      mInit.clear();
+      mRx.attach( nullptr, 0 );
+      mFdRx.attach( nullptr, 0 );
+      mEvents.fill( 0 );
+    }
+
+    DebugMode mode() const
+    {
+      return mInit.debugMode;
+    }
+
+    bool fd() const
+    {
+      return mInit.fdMode;
+    }
+
+    /**
+     *  Checks if the node drives its frames onto the shared bus
+     */
+    bool transmitsOnBus() const
+    {
+      return ( mode() != DebugMode::SILENT ) && ( mode() != DebugMode::LOOPBACK_AND_SILENT );
+    }
+
+    /**
+     *  Checks if the node has a frame waiting for the bus
+     */
+    bool pending() const
+    {
+      return mOpen && transmitsOnBus() && ( !mTx.empty() || !mFdTx.empty() );
+    }
+
+    /**
+     *  Checks if the node sees the bus at all
+     */
+    bool onBus() const
+    {
+      return mOpen && ( mode() != DebugMode::LOOPBACK_AND_SILENT );
+    }
+
+    /**
+     *  Checks if the node hears frames sent by other nodes
+     */
+    bool receivesFromBus() const
+    {
+      return ( mode() != DebugMode::LOOPBACK ) && ( mode() != DebugMode::LOOPBACK_AND_SILENT );
+    }
+
+    /**
+     *  Checks if the node drives the ACK slot for other nodes
+     */
+    bool acknowledges() const
+    {
+      return receivesFromBus() && ( mode() != DebugMode::SILENT );
+    }
+
+    /**
+     *  Checks if the node receives its own frames
+     */
+    bool loopsBack() const
+    {
+      return ( mode() == DebugMode::LOOPBACK ) || ( mode() == DebugMode::LOOPBACK_AND_SILENT );
+    }
+
+    void notify( const Chimera::Event::Trigger event, const uint32_t value )
+    {
+      std::lock_guard<std::recursive_mutex> lck( mListenerLock );
+      Chimera::Event::notifyListenerList( event, mListeners, value );
+    }
+  };
+
+
+  /**
+   *  The shared wire. A single thread stands in for the bit level protocol:
+   *  it picks the winning frame, holds the bus for the frame's duration, then
+   *  hands it to every node that can hear it.
+   */
+  class VirtualBus
+  {
+  public:
+    std::mutex mLock;
+    std::condition_variable mWake;   /**< Signals the bus thread */
+    std::condition_variable mEvents; /**< Signals threads blocked in await() */
+
+    VirtualBus() : mRunning( false ), mBaudRate( 0 ), mDataBaudRate( 0 ), mNowNs( 0 ), mStatsStartNs( 0 )
+    {
+      mConfig.clear();
+      mStats.clear();
+      mNodes.fill( nullptr );
+      mEpoch = std::chrono::steady_clock::now();
+    }
+
+    ~VirtualBus()
+    {
+      {
+        std::lock_guard<std::mutex> lck( mLock );
+        mRunning = false;
+      }
+
+      mWake.notify_all();
+      if ( mThread.joinable() )
+      {
+        mThread.join();
+      }
+    }
+
+    /**
+     *  Adds a node to the bus. Bus lock must be held.
+     */
+    Chimera::Status_t attach( SimCAN *const node, const size_t index )
+    {
+      /*-------------------------------------------------
+      Nodes at different rates can't decode each other
+      -------------------------------------------------*/
+      for ( size_t idx = 0; idx < NUM_CHANNELS; idx++ )
+      {
+        auto other = mNodes[ idx ];
+        if ( ( idx == index ) || !other )
+        {
+          continue;
+        }
+
+        if ( ( mBaudRate != node->mInit.baudRate ) ||
+             ( node->fd() && other->fd() && ( other->mInit.dataBaudRate != node->mInit.dataBaudRate ) ) )
+        {
+          return Chimera::Status::FAIL;
+        }
+      }
+
+      mBaudRate       = node->mInit.baudRate;
+      mNodes[ index ] = node;
+
+      if ( node->fd() )
+      {
+        mDataBaudRate = node->mInit.dataBaudRate;
+      }
+
+      if ( !mRunning )
+      {
+        mRunning = true;
+        mThread  = std::thread( &VirtualBus::run, this );
+      }
+
+      return Chimera::Status::OK;
+    }
+
+    /**
+     *  Removes a node from the bus. Bus lock must be held.
+     */
+    void detach( const size_t index )
+    {
+      mNodes[ index ] = nullptr;
+    }
+
+    /**
+     *  Current bus time in nanoseconds. Bus lock must be held.
+     */
+    uint64_t now() const
+    {
+      if ( !mConfig.realTime )
+      {
+        return mNowNs;
+      }
+
+      using namespace std::chrono;
+      return static_cast<uint64_t>( duration_cast<nanoseconds>( steady_clock::now() - mEpoch ).count() );
+    }
+
+    /**
+     *  Current bus time in microseconds, the clock frames are stamped with.
+     *  Bus lock must be held.
+     */
+    size_t micros() const
+    {
+      return static_cast<size_t>( now() / 1000 );
+    }
+
+    void configure( const BusConfig &cfg )
+    {
+      std::lock_guard<std::mutex> lck( mLock );
+
+      /*-------------------------------------------------
+      Carry the clock across so time never runs backward
+      -------------------------------------------------*/
+      const uint64_t current = now();
+      mConfig                = cfg;
+      mNowNs                 = current;
+      mEpoch = std::chrono::steady_clock::now() - std::chrono::nanoseconds( current );
+    }
+
+    BusStats stats()
+    {
+      std::lock_guard<std::mutex> lck( mLock );
+      BusStats snapshot  = mStats;
+      snapshot.elapsedNs = now() - mStatsStartNs;
+      return snapshot;
+    }
+
+    void resetStats()
+    {
+      std::lock_guard<std::mutex> lck( mLock );
+      mStats.clear();
+      mStatsStartNs = now();
+    }
+
+  private:
+    bool mRunning;
+    size_t mBaudRate;
+    size_t mDataBaudRate;
+    uint64_t mNowNs; /**< Bus time when not running in real time */
+    uint64_t mStatsStartNs;
+    BusConfig mConfig;
+    BusStats mStats;
+    std::array<SimCAN *, NUM_CHANNELS> mNodes;
+    std::chrono::steady_clock::time_point mEpoch;
+    std::thread mThread;
+
+    void run()
+    {
+      std::unique_lock<std::mutex> lck( mLock );
+
+      while ( mRunning )
+      {
+        /*-------------------------------------------------
+        Arbitration: each node offers its best pending
+        frame and the lowest key wins. The key's low bit
+        is FDF, so classic frames win ties with FD frames.
+        -------------------------------------------------*/
+        SimCAN *winner    = nullptr;
+        uint64_t best     = 0;
+        size_t contenders = 0;
+
+        for ( auto node : mNodes )
+        {
+          if ( !node || !node->pending() )
+          {
+            continue;
+          }
+
+          uint64_t key = UINT64_MAX;
+          if ( !node->mTx.empty() )
+          {
+            key = Util::arbitrationKey( *node->mTx.top() ) << 1;
+          }
+
+          if ( !node->mFdTx.empty() )
+          {
+            key = std::min( key, ( Util::arbitrationKey( *node->mFdTx.top() ) << 1 ) | 1u );
+          }
+
+          contenders++;
+
+          if ( !winner || ( key < best ) )
+          {
+            winner = node;
+            best   = key;
+          }
+        }
+
+        if ( !winner )
+        {
+          mWake.wait( lck );
+          continue;
+        }
+
+        mStats.arbitrationLost += contenders - 1;
+        for ( auto node : mNodes )
+        {
+          if ( node && ( node != winner ) && node->pending() )
+          {
+            node->mStatus.lostArbitration();
+          }
+        }
+
+        /*-------------------------------------------------
+        Move the frame into the "shift register" while it
+        is on the wire. Its slot stays reserved in case it
+        has to be retransmitted. FD frames spend their data
+        phase at the data rate.
+        -------------------------------------------------*/
+        const bool isFD = ( best & 1u );
+        BasicFrame frame;
+        FDFrame fdFrame;
+        uint64_t stamp     = 0;
+        size_t nominalBits = 0;
+        size_t dataBits    = 0; /**< Bits sent at the data rate */
+
+        if ( isFD )
+        {
+          size_t slot = 0;
+          winner->mFdTx.pop( fdFrame, &slot );
+          winner->mFdTxInFlight = true;
+          winner->mStatus.level( BufferType::TX, winner->mFdTx.size(), true );
+          stamp = winner->mFdTxStamp[ slot ];
+
+          nominalBits = Util::frameBits( fdFrame, dataBits );
+          if ( !fdFrame.bitRateSwitch )
+          {
+            nominalBits += dataBits;
+            dataBits = 0;
+          }
+        }
+        else
+        {
+          size_t slot = 0;
+          winner->mTx.pop( frame, &slot );
+          winner->mTxInFlight = true;
+          winner->mStatus.level( BufferType::TX, winner->mTx.size() );
+          stamp = winner->mTxStamp[ slot ];
+
+          nominalBits = Util::frameBits( frame );
+        }
+
+        const size_t bits = nominalBits + dataBits;
+        uint64_t wireNs   = ( static_cast<uint64_t>( nominalBits ) * 1000000000ull ) / mBaudRate;
+        if ( dataBits )
+        {
+          wireNs += ( static_cast<uint64_t>( dataBits ) * 1000000000ull ) / mDataBaudRate;
+        }
+
+        const uint64_t startNs = now();
+        const uint64_t endNs   = startNs + wireNs;
+
+        if ( mConfig.realTime )
+        {
+          const auto deadline = mEpoch + std::chrono::nanoseconds( endNs );
+          while ( mRunning && ( std::chrono::steady_clock::now() < deadline ) )
+          {
+            mWake.wait_until( lck, deadline );
+          }
+        }
+        else
+        {
+          mNowNs = endNs;
+        }
+
+        /*-------------------------------------------------
+        Without an ACK the frame is lost to an error frame.
+        Loopback nodes acknowledge their own frames. Nodes
+        without FD enabled are FD tolerant: they neither
+        acknowledge nor receive FD frames.
+        -------------------------------------------------*/
+        bool acked = winner->loopsBack();
+        for ( auto node : mNodes )
+        {
+          acked |= ( node && ( node != winner ) && node->mOpen && node->acknowledges() && ( !isFD || node->fd() ) );
+        }
+
+        mStats.busyNs += endNs - startNs;
+        mStats.bits += bits;
+
+        const size_t endUs = static_cast<size_t>( endNs / 1000 );
+
+        for ( auto node : mNodes )
+        {
+          if ( node && node->onBus() )
+          {
+            node->mStatus.busy( endUs, nominalBits, dataBits );
+          }
+        }
+
+        std::array<SimCAN *, NUM_CHANNELS> receivers; /**< Nodes the frame was stored in */
+        std::array<size_t, NUM_CHANNELS> received;    /**< RX depth of each receiver */
+        receivers.fill( nullptr );
+        received.fill( 0 );
+
+        if ( acked )
+        {
+          mStats.frames++;
+          mStats.totalLatencyNs += endNs - stamp;
+          mStats.maxLatencyNs = ( ( endNs - stamp ) > mStats.maxLatencyNs ) ? ( endNs - stamp ) : mStats.maxLatencyNs;
+
+          for ( size_t idx = 0; idx < NUM_CHANNELS; idx++ )
+          {
+            auto node       = mNodes[ idx ];
+            const bool hear = node && node->mOpen && ( !isFD || node->fd() ) &&
+                              ( ( node == winner ) ? node->loopsBack() : node->receivesFromBus() );
+
+            if ( !hear )
+            {
+              continue;
+            }
+
+            if ( isFD && deliver( node, fdFrame, endUs ) )
+            {
+              receivers[ idx ] = node;
+              received[ idx ]  = node->mFdRx.count;
+            }
+            else if ( !isFD && deliver( node, frame, endUs ) )
+            {
+              receivers[ idx ] = node;
+              received[ idx ]  = node->mRx.count;
+            }
+          }
+
+          winner->mEvents[ EnumValue( Chimera::Event::Trigger::TRIGGER_WRITE_COMPLETE ) ]++;
+          winner->mStatus.transmitted( endUs );
+        }
+        else
+        {
+          mStats.ackErrors++;
+          winner->mStatus.txError( true );
+
+          /*-------------------------------------------------
+          Like hardware, keep retrying until acknowledged
+          unless configured for one shot transmission. The
+          frame rejoins arbitration ahead of later frames of
+          the same ID and keeps its original send() time. A
+          flush or close while it was on the wire drops it.
+          -------------------------------------------------*/
+          if ( !mConfig.oneShot && isFD && winner->mFdTxInFlight )
+          {
+            size_t slot = 0;
+            winner->mFdTx.requeue( fdFrame, &slot );
+            winner->mFdTxStamp[ slot ] = stamp;
+            winner->mStatus.level( BufferType::TX, winner->mFdTx.size(), true );
+          }
+          else if ( !mConfig.oneShot && !isFD && winner->mTxInFlight )
+          {
+            size_t slot = 0;
+            winner->mTx.requeue( frame, &slot );
+            winner->mTxStamp[ slot ] = stamp;
+            winner->mStatus.level( BufferType::TX, winner->mTx.size() );
+          }
+        }
+
+        winner->mTxInFlight   = false;
+        winner->mFdTxInFlight = false;
+
+        /*-------------------------------------------------
+        Listeners run without the bus lock so they are free
+        to call back into the driver. Only the copies taken
+        above are used, as mNodes may change once unlocked.
+        -------------------------------------------------*/
+        lck.unlock();
+        mEvents.notify_all();
+
+        if ( acked )
+        {
+          winner->notify( Chimera::Event::Trigger::TRIGGER_WRITE_COMPLETE, 1 );
+        }
+
+        for ( size_t idx = 0; idx < NUM_CHANNELS; idx++ )
+        {
+          if ( receivers[ idx ] )
+          {
+            receivers[ idx ]->notify( Chimera::Event::Trigger::TRIGGER_DATA_AVAILABLE, received[ idx ] );
+          }
+        }
+
+        lck.lock();
+      }
+    }
+
+  public:
+    /**
+     *  Pushes a frame into a node's RX buffer if its filter accepts it, and
+     *  records its arrival time in the parallel timestamp ring. Bus lock must
+     *  be held.
+     *
+     *  @return bool    True if the frame was stored
+     */
+    static bool deliver( SimCAN *const node, const BasicFrame &frame, const size_t timestamp )
+    {
+      size_t slot = 0;
+      if ( !node->mFilter.accept( frame ) )
+      {
+        return false;
+      }
+      else if ( !node->mRx.push( frame, &slot ) )
+      {
+        node->mStatus.overrun();
+        return false;
+      }
+
+      node->mRxStamp[ slot ] = static_cast<uint32_t>( timestamp );
+      node->mStatus.received( timestamp );
+      node->mStatus.level( BufferType::RX, node->mRx.count );
+      node->mEvents[ EnumValue( Chimera::Event::Trigger::TRIGGER_DATA_AVAILABLE ) ]++;
+      return true;
+    }
+
+    static bool deliver( SimCAN *const node, const FDFrame &frame, const size_t timestamp )
+    {
+      size_t slot = 0;
+      if ( !node->mFilter.accept( frame ) )
+      {
+        return false;
+      }
+      else if ( !node->mFdRx.push( frame, &slot ) )
+      {
+        node->mStatus.overrun();
+        return false;
+      }
+
+      node->mFdRxStamp[ slot ] = static_cast<uint32_t>( timestamp );
+      node->mStatus.received( timestamp );
+      node->mStatus.level( BufferType::RX, node->mFdRx.count, true );
+      node->mEvents[ EnumValue( Chimera::Event::Trigger::TRIGGER_DATA_AVAILABLE ) ]++;
+      return true;
+    }
+  };
+
+  /*-------------------------------------------------------------------------------
+  Static Data
+  -------------------------------------------------------------------------------*/
+  static std::array<SimCAN, NUM_CHANNELS> s_nodes;
+  static std::array<Driver, NUM_CHANNELS> s_drivers;
+  static VirtualBus s_bus; /**< Declared last so its thread stops before the nodes are destroyed */
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Queues frames for transmission under a single acquisition of the bus
+   *  lock, waking the bus thread once for the whole batch.
+   *
+   *  @param[in]  node          Node sending the frames
+   *  @param[in]  frames        Frames to send
+   *  @param[in]  count         Number of frames
+   *  @param[out] queued        How many frames from the front were accepted
+   *  @return Chimera::Status_t FULL if the TX buffer ran out of room
+   */
+  static Chimera::Status_t enqueue( SimCAN *const node, const BasicFrame *const frames, const size_t count,
+                                    size_t &queued )
+  {
+    std::unique_lock<std::mutex> lck( s_bus.mLock );
+    queued = 0;
+
+    if ( !node->mOpen )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+    else if ( !count )
+    {
+      return Chimera::Status::OK;
+    }
+
+    /*-------------------------------------------------
+    A silent node may not start a transmission
+    -------------------------------------------------*/
+    if ( node->mode() == DebugMode::SILENT )
+    {
+      return Chimera::Status::NOT_SUPPORTED;
+    }
+
+    /*-------------------------------------------------
+    Loopback and silent never touches the bus, so the
+    frames are received immediately.
+    -------------------------------------------------*/
+    if ( node->mode() == DebugMode::LOOPBACK_AND_SILENT )
+    {
+      const size_t stamp = s_bus.micros();
+      size_t stored      = 0;
+
+      for ( ; queued < count; queued++ )
+      {
+        stored += VirtualBus::deliver( node, frames[ queued ], stamp ) ? 1 : 0;
+        node->mStatus.transmitted( stamp );
+      }
+
+      const size_t depth = node->mRx.count;
+      node->mEvents[ EnumValue( Chimera::Event::Trigger::TRIGGER_WRITE_COMPLETE ) ] += count;
+      lck.unlock();
+
+      s_bus.mEvents.notify_all();
+      node->notify( Chimera::Event::Trigger::TRIGGER_WRITE_COMPLETE, count );
+      if ( stored )
+      {
+        node->notify( Chimera::Event::Trigger::TRIGGER_DATA_AVAILABLE, depth );
+      }
+
+      return Chimera::Status::OK;
+    }
+
+    const uint64_t stamp = s_bus.now();
+    for ( ; queued < count; queued++ )
+    {
+      size_t slot = 0;
+      if ( ( ( node->mTx.size() + ( node->mTxInFlight ? 1 : 0 ) ) >= node->mTx.capacity() ) ||
+           ( node->mTx.push( frames[ queued ], &slot ) != Chimera::Status::OK ) )
+      {
+        break;
+      }
+
+      node->mTxStamp[ slot ] = stamp;
+    }
+
+    node->mStatus.level( BufferType::TX, node->mTx.size() );
+    lck.unlock();
+
+    if ( queued )
+    {
+      s_bus.mWake.notify_one();
+    }
+
+    return ( queued == count ) ? Chimera::Status::OK : Chimera::Status::FULL;
+  }
+
+
+  /**
+   *  Queues an FD frame for transmission. Same debug mode rules as enqueue().
+   *
+   *  @param[in]  node          Node sending the frame
+   *  @param[in]  frame         Frame to send
+   *  @return Chimera::Status_t FULL if the FD TX buffer is out of room
+   */
+  static Chimera::Status_t enqueueFD( SimCAN *const node, const FDFrame &frame )
+  {
+    std::unique_lock<std::mutex> lck( s_bus.mLock );
+
+    if ( !node->mOpen )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+    else if ( !node->fd() || ( node->mode() == DebugMode::SILENT ) )
+    {
+      return Chimera::Status::NOT_SUPPORTED;
+    }
+
+    if ( node->mode() == DebugMode::LOOPBACK_AND_SILENT )
+    {
+      const size_t stamp = s_bus.micros();
+      const bool stored  = VirtualBus::deliver( node, frame, stamp );
+      const size_t depth = node->mFdRx.count;
+      node->mStatus.transmitted( stamp );
+      node->mEvents[ EnumValue( Chimera::Event::Trigger::TRIGGER_WRITE_COMPLETE ) ]++;
+      lck.unlock();
+
+      s_bus.mEvents.notify_all();
+      node->notify( Chimera::Event::Trigger::TRIGGER_WRITE_COMPLETE, 1 );
+      if ( stored )
+      {
+        node->notify( Chimera::Event::Trigger::TRIGGER_DATA_AVAILABLE, depth );
+      }
+
+      return Chimera::Status::OK;
+    }
+
+    size_t slot = 0;
+    if ( ( ( node->mFdTx.size() + ( node->mFdTxInFlight ? 1 : 0 ) ) >= node->mFdTx.capacity() ) ||
+         ( node->mFdTx.push( frame, &slot ) != Chimera::Status::OK ) )
+    {
+      return Chimera::Status::FULL;
+    }
+
+    node->mFdTxStamp[ slot ] = s_bus.now();
+    node->mStatus.level( BufferType::TX, node->mFdTx.size(), true );
+    lck.unlock();
+
+    s_bus.mWake.notify_one();
+    return Chimera::Status::OK;
+  }
+
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  Chimera::Status_t configureBus( const BusConfig &cfg )
+  {
+    s_bus.configure( cfg );
+    s_bus.mWake.notify_all();
+    return Chimera::Status::OK;
+  }
+
+
+  BusStats getBusStats()
+  {
+    return s_bus.stats();
+  }
+
+
+  void resetBusStats()
+  {
+    s_bus.resetStats();
+  }
+
+
+  /*-------------------------------------------------------------------------------
+  Backend Functions
+  -------------------------------------------------------------------------------*/
+  static Chimera::Status_t initialize()
+  {
+    return Chimera::Status::OK;
+  }
+
+
+  static Chimera::Status_t reset()
+  {
+    for ( auto &driver : s_drivers )
+    {
+      driver.close();
+    }
+
+    return Chimera::Status::OK;
+  }
+
+
+  static Driver_rPtr getDriver( const Channel channel )
+  {
+    const size_t idx = EnumValue( channel );
+    return ( idx < NUM_CHANNELS ) ? &s_drivers[ idx ] : nullptr;
+  }
+}  // namespace Chimera::CAN::Sim
+
+
+namespace Chimera::CAN::Backend
+{
+  Chimera::Status_t registerDriver( Chimera::CAN::Backend::DriverConfig &registry )
+  {
+    registry.isSupported = true;
+    registry.initialize  = Sim::initialize;
+    registry.reset       = Sim::reset;
+    registry.getDriver   = Sim::getDriver;
+    return Chimera::Status::OK;
+  }
+}  // namespace Chimera::CAN::Backend
+
+
+namespace Chimera::CAN
+{
+  /*-------------------------------------------------------------------------------
+  Driver Implementation
+  -------------------------------------------------------------------------------*/
+  static inline Sim::SimCAN *impl( void *driver )
+  {
+    return reinterpret_cast<Sim::SimCAN *>( driver );
+  }
+
+
+  Driver::Driver() : mDriver( nullptr )
+  {
+  }
+
+
+  Driver::~Driver()
+  {
+  }
+
+
+  /*-------------------------------------------------
+  Interface: Hardware
+  -------------------------------------------------*/
+  Chimera::Status_t Driver::open( const DriverConfig &cfg )
+  {
+    const auto &init = cfg.HWInit;
+    const size_t idx = EnumValue( init.channel );
+
+    if ( ( idx >= Sim::NUM_CHANNELS ) || !init.txBuffer || !init.txElements || !init.rxBuffer || !init.rxElements ||
+         !init.baudRate )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    if ( init.fdMode && ( !init.fdTxBuffer || !init.fdTxElements || !init.fdRxBuffer || !init.fdRxElements ||
+                          !init.dataBaudRate ) )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    /*-------------------------------------------------
+    Bind to the simulated node named by the config
+    -------------------------------------------------*/
+    auto node = &Sim::s_nodes[ idx ];
+    std::lock_guard<std::mutex> lck( Sim::s_bus.mLock );
+
+    if ( node->mOpen )
+    {
+      Sim::s_bus.detach( idx );
+    }
+
+    node->mInit         = init;
+    node->mTxInFlight   = false;
+    node->mFdTxInFlight = false;
+    node->mTx.attach( init.txBuffer, init.txElements );
+    node->mRx.attach( init.rxBuffer, init.rxElements );
+    node->mTxStamp.assign( node->mTx.capacity(), 0 );
+    node->mRxStamp.assign( init.rxElements, 0 );
+    node->mFilter.clear();
+
+    node->mStatus.reset( Sim::s_bus.micros(), init.baudRate, init.fdMode ? init.dataBaudRate : 0 );
+    node->mStatus.capacity( BufferType::TX, node->mTx.capacity() );
+    node->mStatus.capacity( BufferType::RX, init.rxElements );
+
+    if ( init.fdMode )
+    {
+      node->mFdTx.attach( init.fdTxBuffer, init.fdTxElements );
+      node->mFdRx.attach( init.fdRxBuffer, init.fdRxElements );
+      node->mFdTxStamp.assign( node->mFdTx.capacity(), 0 );
+      node->mFdRxStamp.assign( init.fdRxElements, 0 );
+      node->mStatus.capacity( BufferType::TX, node->mFdTx.capacity(), true );
+      node->mStatus.capacity( BufferType::RX, init.fdRxElements, true );
+    }
+    else
+    {
+      node->mFdTx.clear();
+      node->mFdRx.attach( nullptr, 0 );
+    }
+
+    auto result = Sim::s_bus.attach( node, idx );
+    node->mOpen = ( result == Chimera::Status::OK );
+
+    if ( node->mOpen )
+    {
+      mDriver = node;
+    }
+
+    return result;
+  }
+
+
+  Chimera::Status_t Driver::close()
+  {
+    if ( !mDriver )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+
+    auto node = impl( mDriver );
+    {
+      std::lock_guard<std::mutex> lck( Sim::s_bus.mLock );
+      if ( node->mOpen )
+      {
+        Sim::s_bus.detach( EnumValue( node->mInit.channel ) );
+      }
+
+      node->mOpen         = false;
+      node->mTxInFlight   = false;
+      node->mFdTxInFlight = false;
+      node->mTx.clear();
+      node->mRx.clear();
+      node->mFdTx.clear();
+      node->mFdRx.clear();
+    }
+
+    Sim::s_bus.mEvents.notify_all();
+    return Chimera::Status::OK;
+  }
+
+
+  CANStatus Driver::getStatus()
+  {
+    if ( !mDriver )
+    {
+      CANStatus status;
+      status.clear();
+      return status;
+    }
+
+    auto node = impl( mDriver );
+    std::lock_guard<std::mutex> lck( Sim::s_bus.mLock );
+    return node->mStatus.snapshot( Sim::s_bus.micros() );
+  }
+
+
+  void Driver::resetStatus()
+  {
+    if ( !mDriver )
+    {
+      return;
+    }
+
+    auto node = impl( mDriver );
+    std::lock_guard<std::mutex> lck( Sim::s_bus.mLock );
+    node->mStatus.clearCounters();
+  }
+
+
+  Chimera::Status_t Driver::send( const BasicFrame &frame )
+  {
+    if ( !mDriver )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+
+    size_t queued = 0;
+    return Sim::enqueue( impl( mDriver ), &frame, 1, queued );
+  }
+
+
+  Chimera::Status_t Driver::receive( BasicFrame &frame )
+  {
+    uint32_t timestamp = 0;
+    return receive( frame, timestamp );
+  }
+
+
+  Chimera::Status_t Driver::receive( BasicFrame &frame, uint32_t &timestamp )
+  {
+    if ( !mDriver )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+
+    auto node = impl( mDriver );
+    std::lock_guard<std::mutex> lck( Sim::s_bus.mLock );
+
+    size_t slot = 0;
+    if ( !node->mRx.pop( frame, &slot ) )
+    {
+      return Chimera::Status::EMPTY;
+    }
+
+    timestamp = node->mRxStamp[ slot ];
+    node->mStatus.level( BufferType::RX, node->mRx.count );
+    return Chimera::Status::OK;
+  }
+
+
+  size_t Driver::sendBurst( const BasicFrame *const frames, const size_t count )
+  {
+    if ( !mDriver )
+    {
+      return 0;
+    }
+
+    size_t queued = 0;
+    if ( frames )
+    {
+      Sim::enqueue( impl( mDriver ), frames, count, queued );
+    }
+
+    return queued;
+  }
+
+
+  size_t Driver::receiveBurst( BasicFrame *const frames, const size_t count )
+  {
+    if ( !mDriver )
+    {
+      return 0;
+    }
+
+    if ( !frames )
+    {
+      return 0;
+    }
+
+    auto node = impl( mDriver );
+    std::lock_guard<std::mutex> lck( Sim::s_bus.mLock );
+
+    size_t copied = 0;
+    while ( ( copied < count ) && node->mRx.pop( frames[ copied ] ) )
+    {
+      copied++;
+    }
+
+    node->mStatus.level( BufferType::RX, node->mRx.count );
+
+    return copied;
+  }
+
+
+  Chimera::Status_t Driver::filter( const Filter *const list, const size_t size )
+  {
+    if ( !mDriver )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+
+    auto node = impl( mDriver );
+    std::lock_guard<std::mutex> lck( Sim::s_bus.mLock );
+    return node->mFilter.configure( list, size );
+  }
+
+
+  Chimera::Status_t Driver::flush( BufferType buffer )
+  {
+    if ( !mDriver )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+
+    auto node = impl( mDriver );
+    std::lock_guard<std::mutex> lck( Sim::s_bus.mLock );
+
+    switch ( buffer )
+    {
+      case BufferType::TX:
+        node->mTx.clear();
+        node->mFdTx.clear();
+        node->mTxInFlight   = false;
+        node->mFdTxInFlight = false;
+        node->mStatus.level( BufferType::TX, 0 );
+        node->mStatus.level( BufferType::TX, 0, true );
+        return Chimera::Status::OK;
+
+      case BufferType::RX:
+        node->mRx.clear();
+        node->mFdRx.clear();
+        node->mStatus.level( BufferType::RX, 0 );
+        node->mStatus.level( BufferType::RX, 0, true );
+        return Chimera::Status::OK;
+
+      default:
+        return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+  }
+
+
+  size_t Driver::available()
+  {
+    if ( !mDriver )
+    {
+      return 0;
+    }
+
+    auto node = impl( mDriver );
+    std::lock_guard<std::mutex> lck( Sim::s_bus.mLock );
+    return node->mRx.count;
+  }
+
+
+  Chimera::Status_t Driver::sendFD( const FDFrame &frame )
+  {
+    if ( !mDriver )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+
+    /*-------------------------------------------------
+    Only lengths a DLC can encode make it onto the bus
+    -------------------------------------------------*/
+    const size_t length = frame.dataLength;
+    if ( ( length > MAX_FD_PAYLOAD_LENGTH ) || ( Util::fdPaddedLength( length ) != length ) )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    return Sim::enqueueFD( impl( mDriver ), frame );
+  }
+
+
+  Chimera::Status_t Driver::receiveFD( FDFrame &frame )
+  {
+    uint32_t timestamp = 0;
+    return receiveFD( frame, timestamp );
+  }
+
+
+  Chimera::Status_t Driver::receiveFD( FDFrame &frame, uint32_t &timestamp )
+  {
+    if ( !mDriver )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+
+    auto node = impl( mDriver );
+    std::lock_guard<std::mutex> lck( Sim::s_bus.mLock );
+
+    size_t slot = 0;
+    if ( !node->mFdRx.pop( frame, &slot ) )
+    {
+      return Chimera::Status::EMPTY;
+    }
+
+    timestamp = node->mFdRxStamp[ slot ];
+    node->mStatus.level( BufferType::RX, node->mFdRx.count, true );
+    return Chimera::Status::OK;
+  }
+
+
+  size_t Driver::availableFD()
+  {
+    if ( !mDriver )
+    {
+      return 0;
+    }
+
+    auto node = impl( mDriver );
+    std::lock_guard<std::mutex> lck( Sim::s_bus.mLock );
+    return node->mFdRx.count;
+  }
+
+
+  /*-------------------------------------------------
+  Interface: Listener
+  -------------------------------------------------*/
+  Chimera::Status_t Driver::registerListener( Chimera::Event::Actionable &listener, const size_t timeout,
+                                              size_t &registrationID )
+  {
+    if ( !mDriver )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+
+    auto node = impl( mDriver );
+    std::lock_guard<std::recursive_mutex> lck( node->mListenerLock );
+
+    listener.id    = ++node->mNextListenerId;
+    registrationID = listener.id;
+    node->mListeners.push_back( listener );
+    return Chimera::Status::OK;
+  }
+
+
+  Chimera::Status_t Driver::removeListener( const size_t registrationID, const size_t timeout )
+  {
+    if ( !mDriver )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+
+    auto node = impl( mDriver );
+    std::lock_guard<std::recursive_mutex> lck( node->mListenerLock );
+
+    for ( auto iter = node->mListeners.begin(); iter != node->mListeners.end(); iter++ )
+    {
+      if ( iter->id == registrationID )
+      {
+        node->mListeners.erase( iter );
+        return Chimera::Status::OK;
+      }
+    }
+
+    return Chimera::Status::NOT_FOUND;
+  }
+
+
+  /*-------------------------------------------------
+  Interface: AsyncIO
+  -------------------------------------------------*/
+  Chimera::Status_t Driver::await( const Chimera::Event::Trigger event, const size_t timeout )
+  {
+    if ( !mDriver )
+    {
+      return Chimera::Status::NOT_READY;
+    }
+
+    const size_t idx = EnumValue( event );
+    if ( idx >= Sim::NUM_TRIGGERS )
+    {
+      return Chimera::Status::INVAL_FUNC_PARAM;
+    }
+
+    auto node = impl( mDriver );
+    std::unique_lock<std::mutex> lck( Sim::s_bus.mLock );
+
+    const size_t start = node->mEvents[ idx ];
+    auto signaled      = [ & ]() { return !node->mOpen || ( node->mEvents[ idx ] != start ); };
+
+    if ( timeout == Chimera::Thread::TIMEOUT_BLOCK )
+    {
+      Sim::s_bus.mEvents.wait( lck, signaled );
+    }
+    else if ( !Sim::s_bus.mEvents.wait_for( lck, std::chrono::milliseconds( timeout ), signaled ) )
+    {
+      return Chimera::Status::TIMEOUT;
+    }
+
+    return node->mOpen ? Chimera::Status::OK : Chimera::Status::FAIL;
+  }
+
+
+  Chimera::Status_t Driver::await( const Chimera::Event::Trigger event, Chimera::Thread::BinarySemaphore &notifier,
+                                   const size_t timeout )
+  {
+    auto result = await( event, timeout );
+    if ( result == Chimera::Status::OK )
+    {
+      notifier.release();
+    }
+
+    return result;
+  }
+
+
+  /*-------------------------------------------------
+  Interface: Lockable
+  -------------------------------------------------*/
+  void Driver::lock()
+  {
+    if ( mDriver )
+    {
+      impl( mDriver )->mMutex.lock();
+    }
+  }
+
+
+  void Driver::lockFromISR()
+  {
+    if ( mDriver )
+    {
+      impl( mDriver )->mMutex.lock();
+    }
+  }
+
+
+  bool Driver::try_lock_for( const size_t timeout )
+  {
+    return mDriver && impl( mDriver )->mMutex.try_lock_for( timeout );
+  }
+
+
+  void Driver::unlock()
+  {
+    if ( mDriver )
+    {
+      impl( mDriver )->mMutex.unlock();
+    }
+  }
+
+
+  void Driver::unlockFromISR()
+  {
+    if ( mDriver )
+    {
+      impl( mDriver )->mMutex.unlock();
+    }
+  }
+}  // namespace Chimera::CAN
+
+#endif /* USING_NATIVE_THREADS */
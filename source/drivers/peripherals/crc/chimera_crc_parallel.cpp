@@ -0,0 +1,214 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_crc_parallel.cpp
+ *
+ *  Description:
+ *    Worker thread management for parallel CRC calculations
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#if defined( USING_NATIVE_THREADS )
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif /* USING_NATIVE_THREADS */
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/crc>
+#include <Chimera/thread>
+
+namespace Chimera::CRC
+{
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Thread entry point for a single job
+   *
+   *  @param[in]  arg       The ParallelJob to execute
+   *  @return void
+   */
+  static void runJob( void *arg )
+  {
+    ParallelJob *job = reinterpret_cast<ParallelJob *>( arg );
+    job->crc         = job->compute( job->data, job->length );
+  }
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+#if defined( USING_NATIVE_THREADS )
+  /**
+   *  Fixed set of worker threads, started on first use and kept for the life
+   *  of the program so each parallel CRC doesn't pay for thread creation.
+   *  Worker N always executes job N + 1, the caller handles job 0.
+   */
+  class WorkerPool
+  {
+  public:
+    static constexpr size_t NUM_WORKERS = CHIMERA_CRC_PARALLEL_MAX_THREADS - 1;
+
+    WorkerPool() : mStop( false ), mBatch( 0 ), mActive( 0 ), mPending( 0 ), mJobs( nullptr )
+    {
+      for ( size_t idx = 0; idx < mWorkers.size(); idx++ )
+      {
+        mWorkers[ idx ] = std::thread( &WorkerPool::run, this, idx );
+      }
+    }
+
+    ~WorkerPool()
+    {
+      {
+        std::lock_guard<std::mutex> lck( mLock );
+        mStop = true;
+      }
+
+      mStart.notify_all();
+
+      for ( auto &worker : mWorkers )
+      {
+        worker.join();
+      }
+    }
+
+    /**
+     *  Runs a batch of jobs, returning once all of them are finished
+     *
+     *  @param[in]  jobs        Jobs to execute
+     *  @param[in]  count       Number of jobs
+     *  @return void
+     */
+    void execute( ParallelJob *const jobs, const size_t count )
+    {
+      /*-------------------------------------------------
+      Only one batch owns the workers at a time. Anyone
+      else, including a job that recurses, runs inline.
+      -------------------------------------------------*/
+      std::unique_lock<std::mutex> owner( mOwner, std::try_to_lock );
+      if ( !owner.owns_lock() )
+      {
+        for ( size_t idx = 0; idx < count; idx++ )
+        {
+          runJob( &jobs[ idx ] );
+        }
+        return;
+      }
+
+      const size_t numWorkers = std::min<size_t>( count - 1, mWorkers.size() );
+      {
+        std::lock_guard<std::mutex> lck( mLock );
+        mJobs    = jobs;
+        mActive  = numWorkers;
+        mPending = numWorkers;
+        mBatch++;
+      }
+
+      mStart.notify_all();
+
+      /*-------------------------------------------------
+      Do a share of the work while the workers run, plus
+      any jobs beyond the thread limit
+      -------------------------------------------------*/
+      runJob( &jobs[ 0 ] );
+
+      for ( size_t idx = numWorkers + 1; idx < count; idx++ )
+      {
+        runJob( &jobs[ idx ] );
+      }
+
+      std::unique_lock<std::mutex> lck( mLock );
+      mDone.wait( lck, [ this ] { return mPending == 0; } );
+    }
+
+  private:
+    std::array<std::thread, NUM_WORKERS> mWorkers;
+    std::mutex mOwner;              /**< Held by the caller whose batch is running */
+    std::mutex mLock;               /**< Guards the batch state below */
+    std::condition_variable mStart; /**< Signals a new batch or shutdown */
+    std::condition_variable mDone;  /**< Signals the last worker finished */
+    bool mStop;                     /**< Workers should exit */
+    size_t mBatch;                  /**< Incremented for each new batch */
+    size_t mActive;                 /**< Workers taking part in the current batch */
+    size_t mPending;                /**< Workers still running the current batch */
+    ParallelJob *mJobs;             /**< Jobs of the current batch */
+
+    void run( const size_t index )
+    {
+      size_t seen = 0;
+      std::unique_lock<std::mutex> lck( mLock );
+
+      while ( true )
+      {
+        mStart.wait( lck, [ this, &seen ] { return mStop || ( mBatch != seen ); } );
+        if ( mStop )
+        {
+          return;
+        }
+
+        seen = mBatch;
+        if ( index >= mActive )
+        {
+          continue;
+        }
+
+        ParallelJob *job = &mJobs[ index + 1 ];
+        lck.unlock();
+        runJob( job );
+        lck.lock();
+
+        if ( --mPending == 0 )
+        {
+          mDone.notify_one();
+        }
+      }
+    }
+  };
+#endif /* USING_NATIVE_THREADS */
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  size_t parallelChunks( const size_t length )
+  {
+#if defined( USING_NATIVE_THREADS )
+    const size_t cores   = static_cast<size_t>( std::max( Chimera::Thread::hardwareConcurrency(), 1 ) );
+    const size_t bySize  = std::max<size_t>( length / CHIMERA_CRC_PARALLEL_MIN_CHUNK, 1 );
+    const size_t threads = std::min<size_t>( cores, CHIMERA_CRC_PARALLEL_MAX_THREADS );
+
+    return std::min( bySize, threads );
+#else
+    return 1;
+#endif /* USING_NATIVE_THREADS */
+  }
+
+
+  void runParallel( ParallelJob *const jobs, const size_t count )
+  {
+    if ( !jobs || !count )
+    {
+      return;
+    }
+
+#if defined( USING_NATIVE_THREADS )
+    /*-------------------------------------------------
+    Plain STL threads rather than Chimera tasks, so the
+    pool never competes for a task registry slot. It is
+    built on first use and reused by every later call.
+    -------------------------------------------------*/
+    static WorkerPool s_pool;
+    s_pool.execute( jobs, count );
+#else
+    for ( size_t idx = 0; idx < count; idx++ )
+    {
+      runJob( &jobs[ idx ] );
+    }
+#endif /* USING_NATIVE_THREADS */
+  }
+}  // namespace Chimera::CRC
@@ -0,0 +1,445 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_crc_software.cpp
+ *
+ *  Description:
+ *    Table driven software CRC engine
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+/* Aurora Includes */
+#include <Aurora/utility>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/crc>
+#include <Chimera/thread>
+
+#if ( CHIMERA_CRC_SOFTWARE_CLMUL )
+#include <immintrin.h>
+#endif
+
+namespace Chimera::CRC
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr uint8_t MIN_WIDTH    = 1;
+  static constexpr uint8_t MAX_WIDTH    = 32;
+  static constexpr size_t NUM_SLICES    = CHIMERA_CRC_SOFTWARE_SLICES;
+  static constexpr size_t NUM_SETS      = CHIMERA_CRC_SOFTWARE_TABLE_SETS;
+  static constexpr size_t CLMUL_BLOCK   = 16;
+  static constexpr size_t CLMUL_MIN_LEN = 4 * CLMUL_BLOCK; /**< Shorter runs don't recover the setup cost */
+
+  static_assert( ( NUM_SLICES == 1 ) || ( NUM_SLICES == 4 ) || ( NUM_SLICES == 8 ) || ( NUM_SLICES == 16 ) );
+  static_assert( NUM_SETS > 0 );
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Lookup tables for one polynomial/width pair, shared by every engine
+   *  initialized with that pair
+   */
+  struct SoftwareTables
+  {
+    std::array<std::array<uint32_t, 256>, NUM_SLICES> table; /**< Tables operating on the left aligned CRC */
+    uint32_t polynomial;                                     /**< Polynomial as given to init() */
+    uint32_t x128;                                           /**< x^128 mod P, for carry-less folding */
+    uint32_t x192;                                           /**< x^192 mod P, for carry-less folding */
+    uint8_t width;                                           /**< CRC width in bits */
+    size_t users;                                            /**< Engines currently using the set */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Static Data
+  -------------------------------------------------------------------------------*/
+  static Chimera::Thread::RecursiveMutex s_table_lock;
+  static std::array<SoftwareTables, NUM_SETS> s_tables;
+  static std::array<SoftwareCRC, EnumValue( Channel::NUM_OPTIONS )> s_sw_drivers;
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Computes x^power mod P, right aligned with bit N holding x^N
+   *
+   *  @param[in]  polynomial    P without its top bit
+   *  @param[in]  width         Degree of P
+   *  @param[in]  power         Exponent
+   *  @return uint32_t
+   */
+  static uint32_t xpow( const uint32_t polynomial, const uint8_t width, size_t power )
+  {
+    const uint32_t mask = ( width == MAX_WIDTH ) ? 0xFFFFFFFFu : ( ( 1u << width ) - 1u );
+    uint32_t result     = 1u;
+
+    while ( power-- )
+    {
+      const bool carry = ( result >> ( width - 1 ) ) & 1u;
+      result           = ( ( result << 1 ) & mask ) ^ ( carry ? polynomial : 0u );
+    }
+
+    return result;
+  }
+
+
+  /**
+   *  Fills in the lookup tables for a polynomial
+   *
+   *  @param[out] set           Tables to build
+   *  @param[in]  polynomial    Polynomial, already masked to the width
+   *  @param[in]  width         CRC width in bits
+   *  @return void
+   */
+  static void buildTables( SoftwareTables &set, const uint32_t polynomial, const uint8_t width )
+  {
+    /*-------------------------------------------------
+    The engine works on a CRC register that is left
+    aligned in 32 bits so any width shares the same
+    byte at a time algorithm.
+    -------------------------------------------------*/
+    const uint32_t poly = polynomial << ( MAX_WIDTH - width );
+
+    for ( uint32_t byte = 0; byte < 256; byte++ )
+    {
+      uint32_t crc = byte << 24;
+
+      for ( size_t bit = 0; bit < 8; bit++ )
+      {
+        crc = ( crc & 0x80000000u ) ? ( ( crc << 1 ) ^ poly ) : ( crc << 1 );
+      }
+
+      set.table[ 0 ][ byte ] = crc;
+    }
+
+    /*-------------------------------------------------
+    Table N gives the CRC of a byte followed by N zero
+    bytes, letting several bytes be folded in at once.
+    -------------------------------------------------*/
+    for ( size_t slice = 1; slice < NUM_SLICES; slice++ )
+    {
+      for ( size_t byte = 0; byte < 256; byte++ )
+      {
+        uint32_t prev              = set.table[ slice - 1 ][ byte ];
+        set.table[ slice ][ byte ] = ( prev << 8 ) ^ set.table[ 0 ][ prev >> 24 ];
+      }
+    }
+
+    set.polynomial = polynomial;
+    set.width      = width;
+    set.x128       = xpow( polynomial, width, 128 );
+    set.x192       = xpow( polynomial, width, 192 );
+  }
+
+
+  /**
+   *  Runs bytes through the lookup tables
+   *
+   *  @param[in]  set           Tables to use
+   *  @param[in]  crc           Left aligned CRC register
+   *  @param[in]  data          Bytes to process
+   *  @param[in]  length        Number of bytes
+   *  @return uint32_t          Updated register
+   */
+  static uint32_t slice( const SoftwareTables &set, uint32_t crc, const uint8_t *data, size_t length )
+  {
+    /*-------------------------------------------------
+    Fold in blocks of NUM_SLICES bytes. The first four
+    bytes of each block overlap the current CRC, the
+    rest only need their own table lookup.
+    -------------------------------------------------*/
+    if constexpr ( NUM_SLICES >= 4 )
+    {
+      while ( length >= NUM_SLICES )
+      {
+        uint32_t x = crc ^ ( ( static_cast<uint32_t>( data[ 0 ] ) << 24 ) | ( static_cast<uint32_t>( data[ 1 ] ) << 16 ) |
+                             ( static_cast<uint32_t>( data[ 2 ] ) << 8 ) | static_cast<uint32_t>( data[ 3 ] ) );
+
+        crc = set.table[ NUM_SLICES - 1 ][ x >> 24 ] ^ set.table[ NUM_SLICES - 2 ][ ( x >> 16 ) & 0xFF ] ^
+              set.table[ NUM_SLICES - 3 ][ ( x >> 8 ) & 0xFF ] ^ set.table[ NUM_SLICES - 4 ][ x & 0xFF ];
+
+        for ( size_t idx = 4; idx < NUM_SLICES; idx++ )
+        {
+          crc ^= set.table[ NUM_SLICES - 1 - idx ][ data[ idx ] ];
+        }
+
+        data += NUM_SLICES;
+        length -= NUM_SLICES;
+      }
+    }
+
+    /*-------------------------------------------------
+    Whatever is left goes through a byte at a time
+    -------------------------------------------------*/
+    while ( length-- )
+    {
+      crc = ( crc << 8 ) ^ set.table[ 0 ][ ( crc >> 24 ) ^ *data++ ];
+    }
+
+    return crc;
+  }
+
+
+#if ( CHIMERA_CRC_SOFTWARE_CLMUL )
+  /**
+   *  Folds whole 16 byte blocks into a single block that leaves the same
+   *  remainder mod P. With A the running block and B the next one:
+   *
+   *    A * x^128 + B == A_hi * ( x^192 mod P ) + A_lo * ( x^128 mod P ) + B
+   *
+   *  Each product is at most 95 bits wide, so nothing needs reducing until
+   *  the final block goes through the tables. Works for any polynomial since
+   *  only the two constants depend on it.
+   *
+   *  @param[in]  set           Tables to use
+   *  @param[in]  crc           Left aligned CRC register
+   *  @param[in]  data          Bytes to process, advanced past the folded blocks
+   *  @param[in]  length        Number of bytes, reduced by the folded blocks
+   *  @return uint32_t          Updated register
+   */
+  static uint32_t fold( const SoftwareTables &set, uint32_t crc, const uint8_t *&data, size_t &length )
+  {
+    /*-------------------------------------------------
+    Data is MSB first, so byte reverse each block to
+    put the first message bit at bit 127
+    -------------------------------------------------*/
+    const __m128i swap = _mm_set_epi8( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 );
+    const __m128i k    = _mm_set_epi64x( set.x192, set.x128 );
+
+    uint8_t block[ CLMUL_BLOCK ];
+    memcpy( block, data, CLMUL_BLOCK );
+    block[ 0 ] ^= static_cast<uint8_t>( crc >> 24 );
+    block[ 1 ] ^= static_cast<uint8_t>( crc >> 16 );
+    block[ 2 ] ^= static_cast<uint8_t>( crc >> 8 );
+    block[ 3 ] ^= static_cast<uint8_t>( crc );
+
+    __m128i acc = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i *>( block ) ), swap );
+    data += CLMUL_BLOCK;
+    length -= CLMUL_BLOCK;
+
+    while ( length >= CLMUL_BLOCK )
+    {
+      const __m128i next = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i *>( data ) ), swap );
+
+      acc = _mm_xor_si128( _mm_xor_si128( _mm_clmulepi64_si128( acc, k, 0x00 ), _mm_clmulepi64_si128( acc, k, 0x11 ) ),
+                           next );
+
+      data += CLMUL_BLOCK;
+      length -= CLMUL_BLOCK;
+    }
+
+    /*-------------------------------------------------
+    The CRC seed is already folded in, so the last
+    block starts from a clear register
+    -------------------------------------------------*/
+    _mm_storeu_si128( reinterpret_cast<__m128i *>( block ), _mm_shuffle_epi8( acc, swap ) );
+    return slice( set, 0, block, CLMUL_BLOCK );
+  }
+#endif /* CHIMERA_CRC_SOFTWARE_CLMUL */
+
+
+  /**
+   *  Runs bytes through the fastest available path
+   *
+   *  @param[in]  set           Tables to use
+   *  @param[in]  crc           Left aligned CRC register
+   *  @param[in]  data          Bytes to process
+   *  @param[in]  length        Number of bytes
+   *  @return uint32_t          Updated register
+   */
+  static uint32_t update( const SoftwareTables &set, uint32_t crc, const uint8_t *data, size_t length )
+  {
+#if ( CHIMERA_CRC_SOFTWARE_CLMUL )
+    if ( length >= CLMUL_MIN_LEN )
+    {
+      crc = fold( set, crc, data, length );
+    }
+#endif /* CHIMERA_CRC_SOFTWARE_CLMUL */
+
+    return slice( set, crc, data, length );
+  }
+
+
+  /**
+   *  Gets a table set for a polynomial, building one if no other engine uses it
+   *
+   *  Must be called with s_table_lock held.
+   *
+   *  @param[in]  polynomial    Polynomial, already masked to the width
+   *  @param[in]  width         CRC width in bits
+   *  @return SoftwareTables *  nullptr if every set is in use
+   */
+  static SoftwareTables *acquireTables( const uint32_t polynomial, const uint8_t width )
+  {
+    SoftwareTables *unused = nullptr;
+
+    for ( auto &set : s_tables )
+    {
+      if ( set.users && ( set.polynomial == polynomial ) && ( set.width == width ) )
+      {
+        set.users++;
+        return &set;
+      }
+      else if ( !set.users && !unused )
+      {
+        unused = &set;
+      }
+    }
+
+    if ( unused )
+    {
+      buildTables( *unused, polynomial, width );
+      unused->users = 1;
+    }
+
+    return unused;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  ICRC *getSoftwareDriver( const Channel channel )
+  {
+    if ( channel < Channel::NUM_OPTIONS )
+    {
+      return &s_sw_drivers[ EnumValue( channel ) ];
+    }
+    else
+    {
+      return nullptr;
+    }
+  }
+
+  /*-------------------------------------------------------------------------------
+  Software CRC Implementation
+  -------------------------------------------------------------------------------*/
+  SoftwareCRC::SoftwareCRC() : mTables( nullptr ), mCRC( 0 ), mISRLocked( false )
+  {
+  }
+
+
+  SoftwareCRC::~SoftwareCRC()
+  {
+    Chimera::Thread::LockGuard lck( s_table_lock );
+
+    if ( mTables )
+    {
+      mTables->users--;
+    }
+  }
+
+
+  Chimera::Status_t SoftwareCRC::init( const uint32_t polynomial, const uint8_t crcWidth )
+  {
+    if ( ( crcWidth < MIN_WIDTH ) || ( crcWidth > MAX_WIDTH ) )
+    {
+      return Chimera::Status::NOT_SUPPORTED;
+    }
+
+    const uint32_t mask = ( crcWidth == MAX_WIDTH ) ? 0xFFFFFFFFu : ( ( 1u << crcWidth ) - 1u );
+    const uint32_t poly = polynomial & mask;
+
+    /*-------------------------------------------------
+    Let go of the current set first so a lone user
+    can rebuild it in place for the new polynomial
+    -------------------------------------------------*/
+    Chimera::Thread::LockGuard lck( s_table_lock );
+
+    if ( mTables && ( mTables->polynomial == poly ) && ( mTables->width == crcWidth ) )
+    {
+      mCRC = mask << ( MAX_WIDTH - crcWidth );
+      return Chimera::Status::OK;
+    }
+
+    if ( mTables )
+    {
+      mTables->users--;
+    }
+
+    mTables = acquireTables( poly, crcWidth );
+    if ( !mTables )
+    {
+      return Chimera::Status::MEMORY;
+    }
+
+    mCRC = mask << ( MAX_WIDTH - crcWidth );
+    return Chimera::Status::OK;
+  }
+
+
+  uint32_t SoftwareCRC::accumulate( const uint32_t *const buffer, const uint32_t length )
+  {
+    if ( !mTables || !buffer )
+    {
+      return 0;
+    }
+
+    mCRC = update( *mTables, mCRC, reinterpret_cast<const uint8_t *>( buffer ), length );
+    return output();
+  }
+
+
+  uint32_t SoftwareCRC::calculate( const uint32_t *const buffer, const uint32_t length )
+  {
+    if ( !mTables )
+    {
+      return 0;
+    }
+
+    mCRC = 0xFFFFFFFFu << ( MAX_WIDTH - mTables->width );
+    return accumulate( buffer, length );
+  }
+
+
+  uint32_t SoftwareCRC::getPolynomial()
+  {
+    return mTables ? mTables->polynomial : 0;
+  }
+
+
+  void SoftwareCRC::lock()
+  {
+    mMutex.lock();
+  }
+
+
+  void SoftwareCRC::lockFromISR()
+  {
+    mISRLocked = mMutex.try_lock();
+  }
+
+
+  bool SoftwareCRC::try_lock_for( const size_t timeout )
+  {
+    return mMutex.try_lock_for( timeout );
+  }
+
+
+  void SoftwareCRC::unlock()
+  {
+    mMutex.unlock();
+  }
+
+
+  void SoftwareCRC::unlockFromISR()
+  {
+    if ( mISRLocked )
+    {
+      mISRLocked = false;
+      mMutex.unlock();
+    }
+  }
+
+
+  uint32_t SoftwareCRC::output() const
+  {
+    return mCRC >> ( MAX_WIDTH - mTables->width );
+  }
+}  // namespace Chimera::CRC
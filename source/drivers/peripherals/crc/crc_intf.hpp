@@ -42,6 +42,10 @@ namespace Chimera::CRC
   /**
    * Defines expected behavior for all embedded systems that allow the user to control
    * the CRC hardware.
+   *
+   * The buffer functions take word aligned data. Use Chimera::CRC::Stream or the
+   * byte based calculate() helper for data with arbitrary alignment and length.
+   * Both only ever hand whole words to the driver.
    */
   class HWInterface
   {
@@ -0,0 +1,132 @@
+/********************************************************************************
+ *  File Name:
+ *    crc_parallel.hpp
+ *
+ *  Description:
+ *    Multi-threaded CRC calculation of large buffers
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CRC_PARALLEL_HPP
+#define CHIMERA_CRC_PARALLEL_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/crc/crc_table.hpp>
+
+/*-------------------------------------------------------------------------------
+Literals
+-------------------------------------------------------------------------------*/
+/**
+ *  Upper limit on the number of chunks a buffer is split into. Each chunk past
+ *  the first runs on its own thread.
+ */
+#ifndef CHIMERA_CRC_PARALLEL_MAX_THREADS
+#define CHIMERA_CRC_PARALLEL_MAX_THREADS ( 8 )
+#endif
+
+/**
+ *  Smallest chunk worth handing to another thread. Below this the cost of
+ *  starting the thread outweighs the work.
+ */
+#ifndef CHIMERA_CRC_PARALLEL_MIN_CHUNK
+#define CHIMERA_CRC_PARALLEL_MIN_CHUNK ( 256 * 1024 )
+#endif
+
+namespace Chimera::CRC
+{
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  /**
+   *  A single chunk of a parallel CRC calculation
+   */
+  struct ParallelJob
+  {
+    uint32_t ( *compute )( const uint8_t *const, const size_t ); /**< Calculates the CRC of one chunk */
+    const uint8_t *data;                                         /**< Start of the chunk */
+    size_t length;                                               /**< Bytes in the chunk */
+    uint32_t crc;                                                /**< Result of the calculation */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Decides how many chunks a buffer should be split into, based on its size
+   *  and the number of hardware threads available.
+   *
+   *  @param[in]  length      Size of the buffer in bytes
+   *  @return size_t          Number of chunks, at least one
+   */
+  size_t parallelChunks( const size_t length );
+
+  /**
+   *  Executes the jobs concurrently, returning once all of them are finished.
+   *  The calling thread handles the first job and any beyond
+   *  CHIMERA_CRC_PARALLEL_MAX_THREADS. Without native thread support all the
+   *  jobs run on the calling thread.
+   *
+   *  @param[in]  jobs        Jobs to execute
+   *  @param[in]  count       Number of jobs
+   *  @return void
+   */
+  void runParallel( ParallelJob *const jobs, const size_t count );
+
+  /**
+   *  Calculates the CRC of a large buffer by splitting it into chunks that are
+   *  processed on separate threads, then merging the partial results.
+   *
+   *  @tparam Model           TableCRC model to calculate with
+   *  @param[in]  data        Bytes to calculate the CRC on
+   *  @param[in]  length      Number of bytes
+   *  @return uint32_t        Same result as Model::compute() on the whole buffer
+   */
+  template<class Model>
+  uint32_t parallelCalculate( const void *const data, const size_t length )
+  {
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>( data );
+    const size_t chunks  = parallelChunks( length );
+
+    if ( chunks <= 1 )
+    {
+      return Model::compute( bytes, length );
+    }
+
+    /*-------------------------------------------------
+    Split evenly, with the last chunk taking any slack
+    -------------------------------------------------*/
+    std::array<ParallelJob, CHIMERA_CRC_PARALLEL_MAX_THREADS> jobs;
+    const size_t chunkSize = length / chunks;
+
+    for ( size_t idx = 0; idx < chunks; idx++ )
+    {
+      jobs[ idx ].compute = &Model::compute;
+      jobs[ idx ].data    = bytes + ( idx * chunkSize );
+      jobs[ idx ].length  = ( idx == ( chunks - 1 ) ) ? ( length - ( idx * chunkSize ) ) : chunkSize;
+      jobs[ idx ].crc     = 0;
+    }
+
+    runParallel( jobs.data(), chunks );
+
+    /*-------------------------------------------------
+    Merge the partial results in order
+    -------------------------------------------------*/
+    uint32_t crc = jobs[ 0 ].crc;
+    for ( size_t idx = 1; idx < chunks; idx++ )
+    {
+      crc = Model::combine( crc, jobs[ idx ].crc, jobs[ idx ].length );
+    }
+
+    return crc;
+  }
+}  // namespace Chimera::CRC
+
+#endif /* !CHIMERA_CRC_PARALLEL_HPP */
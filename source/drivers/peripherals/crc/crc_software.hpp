@@ -0,0 +1,134 @@
+/********************************************************************************
+ *  File Name:
+ *    crc_software.hpp
+ *
+ *  Description:
+ *    Table driven software CRC engine for systems without CRC hardware
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CRC_SOFTWARE_HPP
+#define CHIMERA_CRC_SOFTWARE_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/thread>
+#include <Chimera/source/drivers/peripherals/crc/crc_intf.hpp>
+
+/*-------------------------------------------------------------------------------
+Literals
+-------------------------------------------------------------------------------*/
+/**
+ *  Number of lookup tables used by the software engine. Each table costs 1kB
+ *  of RAM. Eight tables process a 64-bit block per iteration and sixteen a
+ *  128-bit block, while a single table falls back to the classic bytewise
+ *  algorithm. Sixteen only pays off on cores with a large data cache.
+ */
+#ifndef CHIMERA_CRC_SOFTWARE_SLICES
+#define CHIMERA_CRC_SOFTWARE_SLICES ( 8 )
+#endif
+
+/**
+ *  Number of distinct polynomial/width pairs the software engines can use at
+ *  the same time. Engines initialized with the same pair share one set of
+ *  tables, so each set costs CHIMERA_CRC_SOFTWARE_SLICES kB no matter how
+ *  many channels use it.
+ */
+#ifndef CHIMERA_CRC_SOFTWARE_TABLE_SETS
+#define CHIMERA_CRC_SOFTWARE_TABLE_SETS ( 1 )
+#endif
+
+/**
+ *  Folds 16 byte blocks with carry-less multiplication before the table
+ *  lookups. Defaults on when the compiler targets PCLMULQDQ and SSSE3, eg
+ *  -mpclmul -mssse3 or -march=native.
+ */
+#ifndef CHIMERA_CRC_SOFTWARE_CLMUL
+#if defined( __PCLMUL__ ) && defined( __SSSE3__ )
+#define CHIMERA_CRC_SOFTWARE_CLMUL ( 1 )
+#else
+#define CHIMERA_CRC_SOFTWARE_CLMUL ( 0 )
+#endif
+#endif
+
+namespace Chimera::CRC
+{
+  /*-------------------------------------------------------------------------------
+  Forward Declarations
+  -------------------------------------------------------------------------------*/
+  struct SoftwareTables;
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Software implementation of the CRC interface, supporting any polynomial
+   *  up to 32 bits wide. Behaves like typical MCU CRC hardware:
+   *
+   *    - Bits are processed MSB first with no input or output reflection
+   *    - The initial value is all ones for the configured width
+   *    - No final XOR is applied
+   *
+   *  Data is consumed as a byte stream in memory order, so results don't depend
+   *  on the endianness of the host.
+   *
+   *  init() returns Status::MEMORY when every CHIMERA_CRC_SOFTWARE_TABLE_SETS
+   *  set is held by engines using a different polynomial or width.
+   *
+   *  ISRs can't wait on a thread, so lockFromISR() only takes the lock if it
+   *  is free. Give ISRs a channel of their own rather than sharing one with
+   *  a thread.
+   */
+  class SoftwareCRC : virtual public ICRC
+  {
+  public:
+    SoftwareCRC();
+    ~SoftwareCRC();
+
+    /*-------------------------------------------------
+    Interface: Hardware
+    -------------------------------------------------*/
+    Chimera::Status_t init( const uint32_t polynomial, const uint8_t crcWidth ) final override;
+    uint32_t accumulate( const uint32_t *const buffer, const uint32_t length ) final override;
+    uint32_t calculate( const uint32_t *const buffer, const uint32_t length ) final override;
+    uint32_t getPolynomial() final override;
+
+    /*-------------------------------------------------
+    Interface: Lockable
+    -------------------------------------------------*/
+    void lock() final override;
+    void lockFromISR() final override;
+    bool try_lock_for( const size_t timeout ) final override;
+    void unlock() final override;
+    void unlockFromISR() final override;
+
+  private:
+    Chimera::Thread::RecursiveTimedMutex mMutex;
+    SoftwareTables *mTables; /**< Shared lookup tables, nullptr if not initialized */
+    uint32_t mCRC;           /**< Left aligned running CRC */
+    bool mISRLocked;         /**< lockFromISR() acquired the mutex */
+
+    uint32_t output() const;
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Gets a software CRC engine for the channel. Intended as a fallback when
+   *  getDriver() returns nullptr because the backend has no CRC hardware.
+   *
+   *  @param[in]  channel     Which engine instance to get
+   *  @return ICRC *          nullptr if the channel is invalid
+   */
+  ICRC *getSoftwareDriver( const Channel channel );
+}  // namespace Chimera::CRC
+
+#endif /* !CHIMERA_CRC_SOFTWARE_HPP */
@@ -0,0 +1,238 @@
+/********************************************************************************
+ *  File Name:
+ *    crc_stream.hpp
+ *
+ *  Description:
+ *    Byte granular streaming CRC on top of the word based CRC interface
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CRC_STREAM_HPP
+#define CHIMERA_CRC_STREAM_HPP
+
+/* STL Includes */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/source/drivers/peripherals/crc/crc_intf.hpp>
+
+/*-------------------------------------------------------------------------------
+Literals
+-------------------------------------------------------------------------------*/
+/**
+ *  Size in words of the stack buffer used to realign data that doesn't start
+ *  on a word boundary.
+ */
+#ifndef CHIMERA_CRC_STREAM_BOUNCE_WORDS
+#define CHIMERA_CRC_STREAM_BOUNCE_WORDS ( 16 )
+#endif
+
+namespace Chimera::CRC
+{
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Feeds arbitrary byte data into a word based CRC driver. Leading and trailing
+   *  bytes that don't fill a whole word are staged internally, while word aligned
+   *  data is handed to the driver in place without copying. Data may arrive in
+   *  any number of update() calls.
+   *
+   *  The driver only ever sees whole words. A 1-3 byte tail left over at final()
+   *  is folded into the driver's result in software, which assumes the model
+   *  SoftwareCRC documents: MSB first, no reflection and no final XOR.
+   *
+   *  The stream doesn't lock the driver. Callers sharing a driver between threads
+   *  should hold its lock from init() through final().
+   *
+   *  @tparam DriverType    Driver, ICRC, or any class with the same accumulate/calculate API
+   */
+  template<class DriverType>
+  class Stream
+  {
+  public:
+    /**
+     *  @param[in]  driver      Driver to calculate with, already initialized
+     *  @param[in]  width       CRC width the driver was initialized with
+     */
+    Stream( DriverType &driver, const uint8_t width ) :
+        mDriver( driver ), mWidth( width ), mStage( 0 ), mStaged( 0 ), mStarted( false ), mCRC( 0 )
+    {
+    }
+
+    /**
+     *  Starts a new CRC calculation, discarding any staged data
+     *
+     *  @return void
+     */
+    void init()
+    {
+      mStage   = 0;
+      mStaged  = 0;
+      mStarted = false;
+      mCRC     = 0;
+    }
+
+    /**
+     *  Adds bytes to the running CRC
+     *
+     *  @param[in]  data      Bytes to add. No alignment required.
+     *  @param[in]  length    Number of bytes
+     *  @return void
+     */
+    void update( const void *const data, size_t length )
+    {
+      const uint8_t *bytes = reinterpret_cast<const uint8_t *>( data );
+      if ( !bytes || !length )
+      {
+        return;
+      }
+
+      /*-------------------------------------------------
+      Top off a partially filled word from a prior call
+      -------------------------------------------------*/
+      if ( mStaged )
+      {
+        size_t fill = std::min( WORD_SIZE - mStaged, length );
+        memcpy( reinterpret_cast<uint8_t *>( &mStage ) + mStaged, bytes, fill );
+
+        mStaged += fill;
+        bytes += fill;
+        length -= fill;
+
+        if ( mStaged < WORD_SIZE )
+        {
+          return;
+        }
+
+        feed( &mStage, WORD_SIZE );
+        mStaged = 0;
+      }
+
+      /*-------------------------------------------------
+      Whole words go straight to the driver if they are
+      aligned, otherwise through a small bounce buffer.
+      -------------------------------------------------*/
+      size_t bulk = length & ~( WORD_SIZE - 1 );
+
+      if ( ( reinterpret_cast<std::uintptr_t>( bytes ) % alignof( uint32_t ) ) == 0 )
+      {
+        if ( bulk )
+        {
+          feed( reinterpret_cast<const uint32_t *>( bytes ), bulk );
+        }
+      }
+      else
+      {
+        std::array<uint32_t, CHIMERA_CRC_STREAM_BOUNCE_WORDS> bounce;
+
+        for ( size_t offset = 0; offset < bulk; )
+        {
+          size_t chunk = std::min( bulk - offset, sizeof( bounce ) );
+          memcpy( bounce.data(), bytes + offset, chunk );
+          feed( bounce.data(), chunk );
+          offset += chunk;
+        }
+      }
+
+      /*-------------------------------------------------
+      Hold onto the trailing bytes until more arrive
+      -------------------------------------------------*/
+      mStage  = 0;
+      mStaged = length - bulk;
+      memcpy( &mStage, bytes + bulk, mStaged );
+    }
+
+    /**
+     *  Finishes the calculation, flushing any staged bytes
+     *
+     *  @return uint32_t      CRC of all the bytes passed to update()
+     */
+    uint32_t final()
+    {
+      /*-------------------------------------------------
+      An empty calculation still needs the driver's seed
+      -------------------------------------------------*/
+      if ( !mStarted )
+      {
+        feed( &mStage, 0 );
+      }
+
+      /*-------------------------------------------------
+      Drivers aren't required to take partial words, so
+      the 1-3 byte tail is finished off here bit by bit.
+      -------------------------------------------------*/
+      if ( mStaged )
+      {
+        const uint32_t top  = 1u << ( mWidth - 1u );
+        const uint32_t mask = top | ( top - 1u );
+        const uint32_t poly = mDriver.getPolynomial() & mask;
+        const uint8_t *tail = reinterpret_cast<const uint8_t *>( &mStage );
+
+        for ( size_t idx = 0; idx < mStaged; idx++ )
+        {
+          for ( int bit = 7; bit >= 0; bit-- )
+          {
+            const uint32_t in  = ( tail[ idx ] >> bit ) & 1u;
+            const uint32_t msb = ( mCRC & top ) ? 1u : 0u;
+
+            mCRC = ( mCRC << 1 ) & mask;
+            if ( in ^ msb )
+            {
+              mCRC ^= poly;
+            }
+          }
+        }
+
+        mStaged = 0;
+      }
+
+      return mCRC;
+    }
+
+  private:
+    static constexpr size_t WORD_SIZE = sizeof( uint32_t );
+
+    DriverType &mDriver;
+    uint8_t mWidth;   /**< CRC width the driver was initialized with */
+    uint32_t mStage;  /**< Partial word waiting on more data */
+    size_t mStaged;   /**< Number of valid bytes in mStage */
+    bool mStarted;    /**< Driver has seen data since init() */
+    uint32_t mCRC;    /**< Most recent result from the driver */
+
+    void feed( const uint32_t *const buffer, const size_t length )
+    {
+      mCRC     = mStarted ? mDriver.accumulate( buffer, length ) : mDriver.calculate( buffer, length );
+      mStarted = true;
+    }
+  };
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   *  Calculates the CRC of a byte buffer with no alignment or length restrictions
+   *
+   *  @param[in]  driver      Driver to calculate with
+   *  @param[in]  width       CRC width the driver was initialized with
+   *  @param[in]  data        Bytes to calculate the CRC on
+   *  @param[in]  length      Number of bytes
+   *  @return uint32_t
+   */
+  template<class DriverType>
+  uint32_t calculate( DriverType &driver, const uint8_t width, const void *const data, const size_t length )
+  {
+    Stream<DriverType> stream( driver, width );
+    stream.update( data, length );
+    return stream.final();
+  }
+}  // namespace Chimera::CRC
+
+#endif /* !CHIMERA_CRC_STREAM_HPP */
@@ -0,0 +1,360 @@
+/********************************************************************************
+ *  File Name:
+ *    crc_table.hpp
+ *
+ *  Description:
+ *    Fixed CRC models with lookup tables generated at compile time
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ ********************************************************************************/
+
+#pragma once
+#ifndef CHIMERA_CRC_TABLE_HPP
+#define CHIMERA_CRC_TABLE_HPP
+
+/* STL Includes */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/thread>
+#include <Chimera/source/drivers/peripherals/crc/crc_intf.hpp>
+
+namespace Chimera::CRC
+{
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   *  CRC engine for a single, fixed CRC model using the usual Rocksoft parameters.
+   *  The lookup table is generated by the compiler and placed in read only memory,
+   *  so only the models a project actually uses take up any flash.
+   *
+   *  Data is consumed as a byte stream in memory order. Since the model is fixed,
+   *  init() only succeeds when asked for the polynomial and width it was built with.
+   *
+   *  @tparam Width     CRC width in bits, 1-32
+   *  @tparam Poly      Polynomial in normal (MSB first) notation, without the top bit
+   *  @tparam Init      Initial register value
+   *  @tparam RefIn     Process each input byte LSB first
+   *  @tparam RefOut    Reflect the final register before the output XOR
+   *  @tparam XorOut    Value XORed with the result
+   */
+  template<uint8_t Width, uint32_t Poly, uint32_t Init, bool RefIn, bool RefOut, uint32_t XorOut>
+  class TableCRC : virtual public ICRC
+  {
+  public:
+    static_assert( ( Width >= 1 ) && ( Width <= 32 ) );
+
+    /**
+     *  Smallest unsigned type able to hold the CRC register
+     */
+    using value_type = std::conditional_t<( Width <= 8 ), uint8_t, std::conditional_t<( Width <= 16 ), uint16_t, uint32_t>>;
+
+    static constexpr uint32_t MASK = ( Width == 32 ) ? 0xFFFFFFFFu : ( ( 1u << Width ) - 1u );
+
+    /**
+     *  Calculates a CRC entirely at compile time
+     *
+     *  @param[in]  data      Bytes to calculate the CRC on
+     *  @param[in]  length    Number of bytes
+     *  @return uint32_t
+     */
+    static constexpr uint32_t compute( const uint8_t *const data, const size_t length )
+    {
+      return finalize( update( seed(), data, length ) );
+    }
+
+    /**
+     *  Combines the CRCs of two adjacent blocks into the CRC of both blocks
+     *  concatenated, without touching the data again. Lets a large buffer be
+     *  split into pieces that are processed independently.
+     *
+     *  @param[in]  crcA      CRC of the first block
+     *  @param[in]  crcB      CRC of the second block
+     *  @param[in]  lengthB   Length in bytes of the second block
+     *  @return uint32_t      CRC of the first block followed by the second
+     */
+    static constexpr uint32_t combine( const uint32_t crcA, const uint32_t crcB, const size_t lengthB )
+    {
+      /*-------------------------------------------------
+      Register contents are linear in the data, so with
+      shift(r, n) being r * x^(8n) mod P:
+
+        reg(A|B) = shift(reg(A), n) ^ reg(B) ^ shift(seed, n)
+
+      The last term cancels the seed that was used to
+      start the second block.
+      -------------------------------------------------*/
+      const uint32_t xn = xpow8n( lengthB );
+      const uint32_t rA = toNormal( unfinalize( crcA ) );
+      const uint32_t rB = toNormal( unfinalize( crcB ) );
+      const uint32_t rS = toNormal( seed() );
+
+      return finalize( fromNormal( mulmod( rA, xn ) ^ rB ^ mulmod( rS, xn ) ) );
+    }
+
+    TableCRC() : mCRC( seed() ), mISRLocked( false )
+    {
+    }
+
+    ~TableCRC() = default;
+
+    /*-------------------------------------------------
+    Interface: Hardware
+    -------------------------------------------------*/
+    Chimera::Status_t init( const uint32_t polynomial, const uint8_t crcWidth ) final override
+    {
+      if ( ( crcWidth != Width ) || ( ( polynomial & MASK ) != Poly ) )
+      {
+        return Chimera::Status::NOT_SUPPORTED;
+      }
+
+      mCRC = seed();
+      return Chimera::Status::OK;
+    }
+
+    uint32_t accumulate( const uint32_t *const buffer, const uint32_t length ) final override
+    {
+      if ( buffer )
+      {
+        mCRC = update( mCRC, reinterpret_cast<const uint8_t *>( buffer ), length );
+      }
+
+      return finalize( mCRC );
+    }
+
+    uint32_t calculate( const uint32_t *const buffer, const uint32_t length ) final override
+    {
+      mCRC = seed();
+      return accumulate( buffer, length );
+    }
+
+    uint32_t getPolynomial() final override
+    {
+      return Poly;
+    }
+
+    /*-------------------------------------------------
+    Interface: Lockable
+    -------------------------------------------------*/
+    void lock() final override
+    {
+      mMutex.lock();
+    }
+
+    void lockFromISR() final override
+    {
+      mISRLocked = mMutex.try_lock();
+    }
+
+    bool try_lock_for( const size_t timeout ) final override
+    {
+      return mMutex.try_lock_for( timeout );
+    }
+
+    void unlock() final override
+    {
+      mMutex.unlock();
+    }
+
+    void unlockFromISR() final override
+    {
+      if ( mISRLocked )
+      {
+        mISRLocked = false;
+        mMutex.unlock();
+      }
+    }
+
+  private:
+    static_assert( ( Poly & ~MASK ) == 0, "Polynomial is wider than the CRC" );
+    static_assert( ( Init & ~MASK ) == 0, "Initial value is wider than the CRC" );
+    static_assert( ( XorOut & ~MASK ) == 0, "Output XOR is wider than the CRC" );
+
+    /*-------------------------------------------------
+    Normal models keep the register left aligned in
+    value_type so widths under 8 bits work unchanged.
+    -------------------------------------------------*/
+    static constexpr size_t REG_BITS = sizeof( value_type ) * 8;
+    static constexpr size_t SHIFT    = REG_BITS - Width;
+
+    static constexpr uint32_t reflect( uint32_t value, const size_t bits )
+    {
+      uint32_t result = 0;
+
+      for ( size_t idx = 0; idx < bits; idx++ )
+      {
+        result = ( result << 1 ) | ( value & 1u );
+        value >>= 1;
+      }
+
+      return result;
+    }
+
+    static constexpr std::array<value_type, 256> generate()
+    {
+      std::array<value_type, 256> table{};
+
+      for ( uint32_t byte = 0; byte < 256; byte++ )
+      {
+        if constexpr ( RefIn )
+        {
+          uint32_t poly = reflect( Poly, Width );
+          uint32_t crc  = byte;
+
+          for ( size_t bit = 0; bit < 8; bit++ )
+          {
+            crc = ( crc & 1u ) ? ( ( crc >> 1 ) ^ poly ) : ( crc >> 1 );
+          }
+
+          table[ byte ] = static_cast<value_type>( crc );
+        }
+        else
+        {
+          uint32_t top  = 1u << ( REG_BITS - 1 );
+          uint32_t poly = Poly << SHIFT;
+          uint32_t crc  = byte << ( REG_BITS - 8 );
+
+          for ( size_t bit = 0; bit < 8; bit++ )
+          {
+            crc = ( crc & top ) ? ( ( crc << 1 ) ^ poly ) : ( crc << 1 );
+          }
+
+          table[ byte ] = static_cast<value_type>( crc );
+        }
+      }
+
+      return table;
+    }
+
+    static constexpr std::array<value_type, 256> sTable = generate();
+
+    static constexpr uint32_t seed()
+    {
+      return RefIn ? reflect( Init, Width ) : ( Init << SHIFT );
+    }
+
+    static constexpr uint32_t update( uint32_t crc, const uint8_t *data, size_t length )
+    {
+      while ( length-- )
+      {
+        if constexpr ( RefIn )
+        {
+          crc = ( crc >> 8 ) ^ sTable[ ( crc ^ *data++ ) & 0xFFu ];
+        }
+        else
+        {
+          crc = static_cast<value_type>( ( crc << 8 ) ^ sTable[ ( ( crc >> ( REG_BITS - 8 ) ) ^ *data++ ) & 0xFFu ] );
+        }
+      }
+
+      return crc;
+    }
+
+    static constexpr uint32_t finalize( const uint32_t crc )
+    {
+      uint32_t result = RefIn ? crc : ( crc >> SHIFT );
+
+      if constexpr ( RefIn != RefOut )
+      {
+        result = reflect( result, Width );
+      }
+
+      return ( result ^ XorOut ) & MASK;
+    }
+
+    static constexpr uint32_t unfinalize( const uint32_t crc )
+    {
+      uint32_t result = ( crc ^ XorOut ) & MASK;
+
+      if constexpr ( RefIn != RefOut )
+      {
+        result = reflect( result, Width );
+      }
+
+      return RefIn ? result : ( result << SHIFT );
+    }
+
+    /*-------------------------------------------------
+    GF(2) polynomial math on registers converted to the
+    normal, right aligned form: bit N holds x^N.
+    -------------------------------------------------*/
+    static constexpr uint32_t toNormal( const uint32_t reg )
+    {
+      return RefIn ? reflect( reg, Width ) : ( reg >> SHIFT );
+    }
+
+    static constexpr uint32_t fromNormal( const uint32_t value )
+    {
+      return RefIn ? reflect( value, Width ) : ( value << SHIFT );
+    }
+
+    static constexpr uint32_t mulx( const uint32_t value )
+    {
+      const bool carry = ( value >> ( Width - 1 ) ) & 1u;
+      return ( ( ( value << 1 ) & MASK ) ^ ( carry ? Poly : 0u ) );
+    }
+
+    static constexpr uint32_t mulmod( const uint32_t a, const uint32_t b )
+    {
+      uint32_t result = 0;
+
+      for ( size_t bit = Width; bit > 0; bit-- )
+      {
+        result = mulx( result );
+        if ( ( b >> ( bit - 1 ) ) & 1u )
+        {
+          result ^= a;
+        }
+      }
+
+      return result;
+    }
+
+    static constexpr uint32_t xpow8n( size_t bytes )
+    {
+      /*-------------------------------------------------
+      Square and multiply, starting from x^8 mod P
+      -------------------------------------------------*/
+      uint32_t result = 1u;
+      uint32_t base   = 1u;
+
+      for ( size_t idx = 0; idx < 8; idx++ )
+      {
+        base = mulx( base );
+      }
+
+      while ( bytes )
+      {
+        if ( bytes & 1u )
+        {
+          result = mulmod( result, base );
+        }
+
+        base = mulmod( base, base );
+        bytes >>= 1;
+      }
+
+      return result;
+    }
+
+    Chimera::Thread::RecursiveTimedMutex mMutex;
+    uint32_t mCRC;   /**< Running CRC register */
+    bool mISRLocked; /**< lockFromISR() acquired the mutex */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Aliases
+  -------------------------------------------------------------------------------*/
+  using CRC8        = TableCRC<8, 0x07, 0x00, false, false, 0x00>;                  /**< CRC-8/SMBUS */
+  using CRC8_NRSC5  = TableCRC<8, 0x31, 0xFF, false, false, 0x00>;                  /**< Sensirion, Bosch, etc */
+  using CRC16_CCITT = TableCRC<16, 0x1021, 0xFFFF, false, false, 0x0000>;           /**< CRC-16/CCITT-FALSE */
+  using CRC32       = TableCRC<32, 0x04C11DB7, 0xFFFFFFFF, true, true, 0xFFFFFFFF>; /**< Ethernet, zlib */
+  using CRC32C      = TableCRC<32, 0x1EDC6F41, 0xFFFFFFFF, true, true, 0xFFFFFFFF>; /**< Castagnoli, iSCSI, ext4 */
+}  // namespace Chimera::CRC
+
+#endif /* !CHIMERA_CRC_TABLE_HPP */
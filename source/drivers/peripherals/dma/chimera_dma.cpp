@@ -83,7 +83,17 @@ namespace Chimera::DMA
   {
     if ( s_backend_driver.isSupported && s_backend_driver.constructPipe )
     {
-      return s_backend_driver.constructPipe( config );
+      RequestId pipe = s_backend_driver.constructPipe( config );
+      /*-------------------------------------------------
+      A pipe whose priority can't be recorded would be
+      silently queued at LOW, so refuse it instead
+      -------------------------------------------------*/
+      if ( ( pipe != INVALID_REQUEST ) && !Util::setPipePriority( pipe, config.priority ) )
+      {
+        pipe = INVALID_REQUEST;
+      }
+
+      return pipe;
     }
     else
     {
@@ -117,4 +127,46 @@ namespace Chimera::DMA
     }
   }
 
+
+  RequestId transfer( const PipeChainTransfer &transfer )
+  {
+    if ( !s_backend_driver.isSupported )
+    {
+      return INVALID_REQUEST;
+    }
+    else if ( s_backend_driver.pipeChainTransfer )
+    {
+      return s_backend_driver.pipeChainTransfer( transfer );
+    }
+    else if ( s_backend_driver.pipeTransfer )
+    {
+      return Util::emulateChain( transfer, s_backend_driver.pipeTransfer );
+    }
+    else
+    {
+      return INVALID_REQUEST;
+    }
+  }
+
+
+  RequestId transfer( const MemChainTransfer &transfer )
+  {
+    if ( !s_backend_driver.isSupported )
+    {
+      return INVALID_REQUEST;
+    }
+    else if ( s_backend_driver.memChainTransfer )
+    {
+      return s_backend_driver.memChainTransfer( transfer );
+    }
+    else if ( s_backend_driver.memTransfer )
+    {
+      return Util::emulateChain( transfer, s_backend_driver.memTransfer );
+    }
+    else
+    {
+      return INVALID_REQUEST;
+    }
+  }
+
 }  // namespace Chimera::DMA
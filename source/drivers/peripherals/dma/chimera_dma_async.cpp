@@ -0,0 +1,387 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_dma_async.cpp
+ *
+ *  Description:
+ *    DMA accelerated memcpy/memset that return before the operation finishes
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/dma>
+#include <Chimera/thread>
+
+/*-------------------------------------------------------------------------------
+Literals
+-------------------------------------------------------------------------------*/
+#ifndef CHIMERA_DMA_ASYNC_MIN_SIZE
+#define CHIMERA_DMA_ASYNC_MIN_SIZE ( 256 )
+#endif
+
+#ifndef CHIMERA_DMA_ASYNC_MAX_INFLIGHT
+#define CHIMERA_DMA_ASYNC_MAX_INFLIGHT ( 4 )
+#endif
+
+#ifndef CHIMERA_DMA_ASYNC_MAX_SEGMENTS
+#define CHIMERA_DMA_ASYNC_MAX_SEGMENTS ( 24 )
+#endif
+
+#ifndef CHIMERA_DMA_MEMSET_SEED_SIZE
+#define CHIMERA_DMA_MEMSET_SEED_SIZE ( 32 )
+#endif
+
+
+namespace Chimera::DMA
+{
+  /*-------------------------------------------------------------------------------
+  Constants
+  -------------------------------------------------------------------------------*/
+  static constexpr size_t INVALID_SLOT = std::numeric_limits<size_t>::max();
+  static constexpr size_t WORD_SIZE    = sizeof( uint32_t );
+
+  static_assert( ( CHIMERA_DMA_MEMSET_SEED_SIZE % WORD_SIZE ) == 0 );
+  static_assert( CHIMERA_DMA_MEMSET_SEED_SIZE <= CHIMERA_DMA_ASYNC_MIN_SIZE );
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  /**
+   * @brief State of a single in-flight asynchronous operation
+   */
+  struct AsyncSlot
+  {
+    std::atomic<bool> busy;                                          /**< Slot is owned by an operation */
+    std::atomic<bool> complete;                                      /**< Operation has finished */
+    std::atomic<bool> error;                                         /**< Operation finished with an error */
+    std::atomic<size_t> generation;                                  /**< Incremented on each allocation */
+    std::atomic<RequestId> requestId;                                /**< ID reserved for the last memcpy, if any */
+    std::array<MemSegment, CHIMERA_DMA_ASYNC_MAX_SEGMENTS> segments; /**< Chain storage for memset */
+
+    void onComplete( const TransferStats &stats )
+    {
+      error    = stats.error;
+      complete = true;
+      busy     = false;
+    }
+  };
+
+  /*-------------------------------------------------------------------------------
+  Static Data
+  -------------------------------------------------------------------------------*/
+  static std::array<AsyncSlot, CHIMERA_DMA_ASYNC_MAX_INFLIGHT> s_slots;
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   * @brief Returns the request ID held by a finished slot to the pool
+   * @note Must be called from thread context, never from the completion callback
+   *
+   * @param slot        Which slot to reclaim the ID from
+   * @return void
+   */
+  static void reclaimRequestId( AsyncSlot &slot )
+  {
+    RequestId id = slot.requestId.exchange( INVALID_REQUEST );
+    if ( id != INVALID_REQUEST )
+    {
+      Util::releaseRequestId( id );
+    }
+  }
+
+
+  /**
+   * @brief Claims an unused operation slot
+   *
+   * The ID of whatever operation last used the slot is released here rather
+   * than in the completion callback, which may run from an ISR.
+   *
+   * @return size_t     INVALID_SLOT if all are in use
+   */
+  static size_t allocateSlot()
+  {
+    for ( size_t idx = 0; idx < s_slots.size(); idx++ )
+    {
+      bool expected = false;
+      if ( s_slots[ idx ].busy.compare_exchange_strong( expected, true ) )
+      {
+        reclaimRequestId( s_slots[ idx ] );
+        s_slots[ idx ].generation++;
+        s_slots[ idx ].error    = false;
+        s_slots[ idx ].complete = false;
+        return idx;
+      }
+    }
+
+    return INVALID_SLOT;
+  }
+
+
+  /**
+   * @brief Returns a slot whose operation never started
+   *
+   * @param slot        Which slot to release
+   * @return void
+   */
+  static void releaseSlot( const size_t slot )
+  {
+    s_slots[ slot ].complete = true;
+    s_slots[ slot ].busy     = false;
+  }
+
+
+  /**
+   * @brief Selects the widest transfer alignment both addresses can share
+   *
+   * @param dst         Destination address
+   * @param src         Source address
+   * @param width       Output for the alignment in bytes
+   * @return Alignment
+   */
+  static Alignment commonAlignment( const std::uintptr_t dst, const std::uintptr_t src, size_t &width )
+  {
+    std::uintptr_t offset = dst ^ src;
+
+    if ( ( offset & ( WORD_SIZE - 1 ) ) == 0 )
+    {
+      width = WORD_SIZE;
+      return Alignment::WORD;
+    }
+    else if ( ( offset & 1 ) == 0 )
+    {
+      width = sizeof( uint16_t );
+      return Alignment::HALF_WORD;
+    }
+    else
+    {
+      width = sizeof( uint8_t );
+      return Alignment::BYTE;
+    }
+  }
+
+  /*-------------------------------------------------------------------------------
+  AsyncHandle Implementation
+  -------------------------------------------------------------------------------*/
+  AsyncHandle::AsyncHandle() : mSlot( INVALID_SLOT ), mGeneration( 0 ), mId( INVALID_REQUEST )
+  {
+  }
+
+
+  AsyncHandle::AsyncHandle( const size_t slot, const size_t generation, const RequestId id ) :
+      mSlot( slot ), mGeneration( generation ), mId( id )
+  {
+  }
+
+
+  bool AsyncHandle::isComplete() const
+  {
+    if ( mSlot >= s_slots.size() )
+    {
+      return true;
+    }
+
+    /*-------------------------------------------------
+    A newer generation means the slot was recycled,
+    which can only happen after this operation ended.
+    -------------------------------------------------*/
+    const AsyncSlot &slot = s_slots[ mSlot ];
+    return ( slot.generation != mGeneration ) || slot.complete;
+  }
+
+
+  bool AsyncHandle::hasError() const
+  {
+    if ( mSlot >= s_slots.size() )
+    {
+      return false;
+    }
+
+    const AsyncSlot &slot = s_slots[ mSlot ];
+    return ( slot.generation == mGeneration ) && slot.complete && slot.error;
+  }
+
+
+  Chimera::Status_t AsyncHandle::wait( const size_t timeout ) const
+  {
+    size_t start = Chimera::millis();
+
+    while ( !isComplete() )
+    {
+      if ( ( Chimera::millis() - start ) >= timeout )
+      {
+        return Chimera::Status::TIMEOUT;
+      }
+
+      Chimera::Thread::this_thread::yield();
+    }
+
+    return hasError() ? Chimera::Status::FAIL : Chimera::Status::OK;
+  }
+
+
+  RequestId AsyncHandle::id() const
+  {
+    return mId;
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  AsyncHandle memcpyAsync( void *const dst, const void *const src, const size_t size )
+  {
+    uint8_t *out      = reinterpret_cast<uint8_t *>( dst );
+    const uint8_t *in = reinterpret_cast<const uint8_t *>( src );
+
+    if ( !dst || !src || !size )
+    {
+      return AsyncHandle();
+    }
+
+    /*-------------------------------------------------
+    Small copies finish faster on the CPU than it takes
+    to set up the DMA hardware.
+    -------------------------------------------------*/
+    size_t slot = ( size < CHIMERA_DMA_ASYNC_MIN_SIZE ) ? INVALID_SLOT : allocateSlot();
+    if ( slot == INVALID_SLOT )
+    {
+      memcpy( dst, src, size );
+      return AsyncHandle();
+    }
+
+    /*-------------------------------------------------
+    Split into a CPU copied head/tail and an aligned
+    body that the DMA hardware moves.
+    -------------------------------------------------*/
+    size_t width        = 0;
+    std::uintptr_t addr = reinterpret_cast<std::uintptr_t>( dst );
+    Alignment alignment = commonAlignment( addr, reinterpret_cast<std::uintptr_t>( src ), width );
+    size_t head         = std::min( ( width - ( addr % width ) ) % width, size );
+    size_t body         = ( ( size - head ) / width ) * width;
+    size_t tail         = size - head - body;
+
+    memcpy( out, in, head );
+    memcpy( out + head + body, in + head + body, tail );
+
+    /*-------------------------------------------------
+    Hand the body off to the DMA hardware, falling back
+    to the CPU if it can't accept the request.
+    -------------------------------------------------*/
+    AsyncSlot &state = s_slots[ slot ];
+    size_t gen       = state.generation;
+
+    MemTransfer request;
+    request.id        = Util::genRequestId();
+    state.requestId   = request.id;
+    request.src       = reinterpret_cast<std::uintptr_t>( in + head );
+    request.dst       = reinterpret_cast<std::uintptr_t>( out + head );
+    request.size      = body;
+    request.priority  = Priority::LOW;
+    request.alignment = alignment;
+    request.callback  = TransferCallback::create<AsyncSlot, &AsyncSlot::onComplete>( state );
+
+    RequestId id = transfer( request );
+    if ( id == INVALID_REQUEST )
+    {
+      memcpy( out + head, in + head, body );
+      reclaimRequestId( state );
+      releaseSlot( slot );
+      return AsyncHandle();
+    }
+
+    return AsyncHandle( slot, gen, id );
+  }
+
+
+  AsyncHandle memsetAsync( void *const dst, const uint8_t value, const size_t size )
+  {
+    uint8_t *out = reinterpret_cast<uint8_t *>( dst );
+
+    if ( !dst || !size )
+    {
+      return AsyncHandle();
+    }
+
+    size_t slot = ( size < CHIMERA_DMA_ASYNC_MIN_SIZE ) ? INVALID_SLOT : allocateSlot();
+    if ( slot == INVALID_SLOT )
+    {
+      memset( dst, value, size );
+      return AsyncHandle();
+    }
+
+    /*-------------------------------------------------
+    CPU fills the unaligned edges and seeds the start
+    of the word aligned body with the fill pattern.
+    -------------------------------------------------*/
+    std::uintptr_t addr = reinterpret_cast<std::uintptr_t>( dst );
+    size_t head         = ( WORD_SIZE - ( addr % WORD_SIZE ) ) % WORD_SIZE;
+    size_t body         = ( ( size - head ) / WORD_SIZE ) * WORD_SIZE;
+    size_t tail         = size - head - body;
+    size_t filled       = std::min<size_t>( CHIMERA_DMA_MEMSET_SEED_SIZE, body );
+    uint8_t *base       = out + head;
+
+    memset( out, value, head );
+    memset( base + body, value, tail );
+    memset( base, value, filled );
+
+    /*-------------------------------------------------
+    Each segment copies everything filled so far into
+    the region right after it. Chained segments execute
+    in order, so every source is complete before use.
+    -------------------------------------------------*/
+    AsyncSlot &state   = s_slots[ slot ];
+    size_t gen         = state.generation;
+    size_t numSegments = 0;
+
+    while ( ( filled < body ) && ( numSegments < state.segments.size() ) )
+    {
+      size_t chunk = std::min( filled, body - filled );
+
+      state.segments[ numSegments ].src  = reinterpret_cast<std::uintptr_t>( base );
+      state.segments[ numSegments ].dst  = reinterpret_cast<std::uintptr_t>( base + filled );
+      state.segments[ numSegments ].size = chunk;
+
+      filled += chunk;
+      numSegments++;
+    }
+
+    /*-------------------------------------------------
+    Anything beyond what the chain can describe gets
+    filled by the CPU. Only reachable for enormous
+    buffers with a small chain length configured.
+    -------------------------------------------------*/
+    memset( base + filled, value, body - filled );
+
+    if ( !numSegments )
+    {
+      releaseSlot( slot );
+      return AsyncHandle();
+    }
+
+    MemChainTransfer request;
+    request.segments    = state.segments.data();
+    request.numSegments = numSegments;
+    request.priority    = Priority::LOW;
+    request.alignment   = Alignment::WORD;
+    request.callback    = TransferCallback::create<AsyncSlot, &AsyncSlot::onComplete>( state );
+
+    RequestId id = transfer( request );
+    if ( id == INVALID_REQUEST )
+    {
+      memset( base, value, body );
+      releaseSlot( slot );
+      return AsyncHandle();
+    }
+
+    return AsyncHandle( slot, gen, id );
+  }
+
+}  // namespace Chimera::DMA
@@ -0,0 +1,246 @@
+/********************************************************************************
+ *  File Name:
+ *    chimera_dma_chain.cpp
+ *
+ *  Description:
+ *    Software emulation of scatter-gather descriptor chains for backends that
+ *    can only execute a single contiguous transfer at a time.
+ *
+ *  2021 | Brandon Braun | brandonbraun653@gmail.com
+ *******************************************************************************/
+
+/* STL Includes */
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/* Chimera Includes */
+#include <Chimera/common>
+#include <Chimera/dma>
+#include <Chimera/thread>
+
+/*-------------------------------------------------------------------------------
+Literals
+-------------------------------------------------------------------------------*/
+#ifndef CHIMERA_DMA_MAX_CHAINS
+#define CHIMERA_DMA_MAX_CHAINS ( 4 )
+#endif
+
+
+namespace Chimera::DMA::Util
+{
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   * @brief Walks a descriptor chain, starting the next segment each time the
+   * previous one reports completion.
+   *
+   * Completion callbacks may run in ISR context, so the slot only flags itself
+   * as finished there. The request ID is returned to the pool the next time a
+   * thread allocates a chain.
+   */
+  class ChainEmulator
+  {
+  public:
+    enum class State : uint8_t
+    {
+      FREE,
+      ACTIVE,
+      DONE
+    };
+
+    std::atomic<State> state;
+
+    RequestId start( const RequestId id, const PipeChainTransfer &transfer, RequestId ( *submit )( const PipeTransfer & ) )
+    {
+      mIsPipe     = true;
+      mPipe       = transfer;
+      mPipeSubmit = submit;
+      mMemSubmit  = nullptr;
+      mCallback   = transfer.callback;
+      mNumSegs    = transfer.numSegments;
+
+      return begin( id );
+    }
+
+    RequestId start( const RequestId id, const MemChainTransfer &transfer, RequestId ( *submit )( const MemTransfer & ) )
+    {
+      mIsPipe     = false;
+      mMem        = transfer;
+      mPipeSubmit = nullptr;
+      mMemSubmit  = submit;
+      mCallback   = transfer.callback;
+      mNumSegs    = transfer.numSegments;
+
+      return begin( id );
+    }
+
+    RequestId id() const
+    {
+      return mId;
+    }
+
+    void onSegmentComplete( const TransferStats &stats )
+    {
+      mBytes += stats.size;
+      mNextSeg++;
+
+      if ( stats.error || ( mNextSeg >= mNumSegs ) )
+      {
+        finish( stats.error );
+      }
+      else if ( !submitNext() )
+      {
+        finish( true );
+      }
+    }
+
+  private:
+    bool mIsPipe;
+    RequestId mId;
+    size_t mNumSegs;
+    size_t mNextSeg;
+    size_t mBytes;
+    TransferCallback mCallback;
+    PipeChainTransfer mPipe;
+    MemChainTransfer mMem;
+    RequestId ( *mPipeSubmit )( const PipeTransfer & );
+    RequestId ( *mMemSubmit )( const MemTransfer & );
+
+    RequestId begin( const RequestId id )
+    {
+      mId      = id;
+      mNextSeg = 0;
+      mBytes   = 0;
+
+      /*-------------------------------------------------
+      The first segment may complete synchronously and
+      finish the whole chain, so the slot must not be
+      touched after a successful submission.
+      -------------------------------------------------*/
+      if ( !submitNext() )
+      {
+        state = State::DONE;
+        return INVALID_REQUEST;
+      }
+
+      return id;
+    }
+
+    bool submitNext()
+    {
+      TransferCallback cb = TransferCallback::create<ChainEmulator, &ChainEmulator::onSegmentComplete>( *this );
+
+      if ( mIsPipe )
+      {
+        const Segment &seg = mPipe.segments[ mNextSeg ];
+        PipeTransfer next  = { mPipe.pipe, seg.addr, seg.size, cb };
+
+        return mPipeSubmit( next ) != INVALID_REQUEST;
+      }
+      else
+      {
+        const MemSegment &seg = mMem.segments[ mNextSeg ];
+        MemTransfer next      = { mId, seg.src, seg.dst, seg.size, mMem.priority, mMem.alignment, cb };
+
+        return mMemSubmit( next ) != INVALID_REQUEST;
+      }
+    }
+
+    void finish( const bool error )
+    {
+      if ( mCallback )
+      {
+        TransferStats stats = { error, mId, mBytes };
+        mCallback( stats );
+      }
+
+      state = State::DONE;
+    }
+  };
+
+  /*-------------------------------------------------------------------------------
+  Static Data
+  -------------------------------------------------------------------------------*/
+  static Chimera::Thread::RecursiveMutex s_chain_lock;
+  static std::array<ChainEmulator, CHIMERA_DMA_MAX_CHAINS> s_chains;
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   * @brief Finds an unused chain slot, recycling any that have finished
+   *
+   * Must be called with the chain lock held.
+   *
+   * @return ChainEmulator *    nullptr if all slots are busy
+   */
+  static ChainEmulator *allocateChain()
+  {
+    ChainEmulator *result = nullptr;
+
+    for ( auto &chain : s_chains )
+    {
+      if ( chain.state == ChainEmulator::State::DONE )
+      {
+        releaseRequestId( chain.id() );
+        chain.state = ChainEmulator::State::FREE;
+      }
+
+      if ( !result && ( chain.state == ChainEmulator::State::FREE ) )
+      {
+        result = &chain;
+      }
+    }
+
+    return result;
+  }
+
+
+  /**
+   * @brief Common start sequence for both chain types
+   *
+   * @param transfer      The chain to execute
+   * @param submit        Backend function that starts a single transfer
+   * @return RequestId
+   */
+  template<typename ChainType, typename SubmitFunc>
+  static RequestId startChain( const ChainType &transfer, SubmitFunc submit )
+  {
+    using namespace Chimera::Thread;
+    LockGuard lck( s_chain_lock );
+
+    if ( !transfer.segments || !transfer.numSegments || !submit )
+    {
+      return INVALID_REQUEST;
+    }
+
+    ChainEmulator *chain = allocateChain();
+    RequestId id         = genRequestId();
+
+    if ( !chain || ( id == INVALID_REQUEST ) )
+    {
+      releaseRequestId( id );
+      return INVALID_REQUEST;
+    }
+
+    chain->state = ChainEmulator::State::ACTIVE;
+    return chain->start( id, transfer, submit );
+  }
+
+  /*-------------------------------------------------------------------------------
+  Public Functions
+  -------------------------------------------------------------------------------*/
+  RequestId emulateChain( const PipeChainTransfer &transfer, RequestId ( *submit )( const PipeTransfer & ) )
+  {
+    return startChain( transfer, submit );
+  }
+
+
+  RequestId emulateChain( const MemChainTransfer &transfer, RequestId ( *submit )( const MemTransfer & ) )
+  {
+    return startChain( transfer, submit );
+  }
+
+}  // namespace Chimera::DMA::Util
@@ -10,13 +10,18 @@
  *******************************************************************************/
 
 /* STL Includes */
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
 
 /* Aurora Includes */
 #include <Aurora/logging>
 
 /* Chimera Includes */
+#include <Chimera/cfg>
 #include <Chimera/common>
+#include <Chimera/container>
 #include <Chimera/dma>
 #include <Chimera/thread>
 
@@ -38,13 +43,214 @@ Literals
 #define CHIMERA_DMA_PIPE_QUEUE_SIZE ( 15 )
 #endif
 
+#ifndef CHIMERA_DMA_SUBMIT_QUEUE_SIZE
+#define CHIMERA_DMA_SUBMIT_QUEUE_SIZE ( 16 )
+#endif
+
+/**
+ *  Pipes that can be assigned a priority above Priority::LOW
+ */
+#ifndef CHIMERA_DMA_MAX_PIPES
+#define CHIMERA_DMA_MAX_PIPES ( 8 )
+#endif
+
+#ifndef CHIMERA_DMA_TELEMETRY_MAX_REQUESTS
+#define CHIMERA_DMA_TELEMETRY_MAX_REQUESTS ( 16 )
+#endif
+
 
 namespace Chimera::DMA::Util
 {
   /*-------------------------------------------------------------------------------
   Constants
   -------------------------------------------------------------------------------*/
-  static constexpr size_t MAX_UUIDS = CHIMERA_DMA_MEM_QUEUE_SIZE + CHIMERA_DMA_PIPE_QUEUE_SIZE;
+  static constexpr size_t MAX_UUIDS      = CHIMERA_DMA_MEM_QUEUE_SIZE + CHIMERA_DMA_PIPE_QUEUE_SIZE;
+  static constexpr size_t NUM_PRIORITIES = EnumValue( Priority::NUM_OPTIONS );
+
+  /*-------------------------------------------------------------------------------
+  Enumerations
+  -------------------------------------------------------------------------------*/
+  /**
+   * @brief Which transfer queue an event happened on
+   */
+  enum class QueueType : uint8_t
+  {
+    PIPE,
+    MEM
+  };
+
+  /*-------------------------------------------------------------------------------
+  Structures
+  -------------------------------------------------------------------------------*/
+  /**
+   * @brief Tracks when a request entered the queue so wait times can be measured
+   */
+  struct QueueEntry
+  {
+    RequestId id;      /**< Request being queued */
+    Priority priority; /**< Level the request was queued at */
+    size_t enqueuedAt; /**< System time in microseconds when queued */
+  };
+
+  /**
+   * @brief Lock-free submission record, timestamped when it was submitted
+   */
+  template<typename TransferType>
+  struct Submission
+  {
+    TransferType transfer; /**< Request data */
+    size_t timestamp;      /**< System time in microseconds when submitted */
+  };
+
+  /**
+   * @brief Entry in the per-request telemetry table
+   */
+  struct TrackedTelemetry
+  {
+    RequestTelemetry stats; /**< Counters reported to the user */
+    size_t lastUse;         /**< Table tick of the most recent update, for LRU eviction */
+  };
+
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   * @brief Set of FIFO queues, one per priority level, with a selectable dequeue policy
+   *
+   * Not thread safe. Callers are expected to hold the module lock.
+   *
+   * @tparam SIZE   Number of requests each priority level can hold
+   */
+  template<size_t SIZE>
+  class PriorityQueue
+  {
+  public:
+    void clear()
+    {
+      for ( auto &queue : mQueues )
+      {
+        queue.clear();
+      }
+
+      mCredits.fill( 0 );
+    }
+
+    bool empty() const
+    {
+      for ( auto &queue : mQueues )
+      {
+        if ( !queue.empty() )
+        {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    bool full( const Priority priority ) const
+    {
+      return mQueues[ EnumValue( priority ) ].full();
+    }
+
+    size_t size( const Priority priority ) const
+    {
+      return mQueues[ EnumValue( priority ) ].size();
+    }
+
+    void push( const RequestId id, const Priority priority, const size_t timestamp )
+    {
+      mQueues[ EnumValue( priority ) ].push( { id, priority, timestamp } );
+    }
+
+    bool pop( QueueEntry &entry, const QueueConfig &config, const size_t timestamp )
+    {
+      if ( empty() )
+      {
+        return false;
+      }
+
+      /*-------------------------------------------------
+      Aged requests jump the line, oldest first, so a
+      steady stream of high priority work can't starve
+      the lower levels indefinitely.
+      -------------------------------------------------*/
+      size_t level = NUM_PRIORITIES;
+
+      if ( config.agingThresholdUs )
+      {
+        size_t oldestWait = 0;
+
+        for ( size_t idx = 0; idx < NUM_PRIORITIES; idx++ )
+        {
+          if ( mQueues[ idx ].empty() )
+          {
+            continue;
+          }
+
+          size_t wait = timestamp - mQueues[ idx ].front().enqueuedAt;
+          if ( ( wait >= config.agingThresholdUs ) && ( wait > oldestWait ) )
+          {
+            oldestWait = wait;
+            level      = idx;
+          }
+        }
+      }
+
+      if ( level == NUM_PRIORITIES )
+      {
+        level = ( config.policy == QueuePolicy::WEIGHTED ) ? selectWeighted( config ) : selectStrict();
+      }
+
+      mQueues[ level ].pop_into( entry );
+      return true;
+    }
+
+  private:
+    std::array<etl::queue<QueueEntry, SIZE, etl::memory_model::MEMORY_MODEL_SMALL>, NUM_PRIORITIES> mQueues;
+    std::array<size_t, NUM_PRIORITIES> mCredits; /**< WEIGHTED: dequeues left per level this round */
+
+    size_t selectStrict() const
+    {
+      for ( size_t idx = NUM_PRIORITIES; idx > 0; idx-- )
+      {
+        if ( !mQueues[ idx - 1 ].empty() )
+        {
+          return idx - 1;
+        }
+      }
+
+      return 0;
+    }
+
+    size_t selectWeighted( const QueueConfig &config )
+    {
+      /*-------------------------------------------------
+      Serve the highest level that still has credit left
+      in this round. Once every non-empty level is out of
+      credit, start a new round.
+      -------------------------------------------------*/
+      for ( size_t attempt = 0; attempt < 2; attempt++ )
+      {
+        for ( size_t idx = NUM_PRIORITIES; idx > 0; idx-- )
+        {
+          if ( !mQueues[ idx - 1 ].empty() && mCredits[ idx - 1 ] )
+          {
+            mCredits[ idx - 1 ]--;
+            return idx - 1;
+          }
+        }
+
+        for ( size_t idx = 0; idx < NUM_PRIORITIES; idx++ )
+        {
+          mCredits[ idx ] = config.weights[ idx ] ? config.weights[ idx ] : 1u;
+        }
+      }
+
+      return selectStrict();
+    }
+  };
+
 
   /*-------------------------------------------------------------------------------
   Aliases
@@ -55,8 +261,13 @@ namespace Chimera::DMA::Util
   using ReqSet    = etl::unordered_set<RequestId, MAX_UUIDS>;
   using MemMap    = etl::unordered_map<RequestId, MemTransfer, CHIMERA_DMA_MEM_QUEUE_SIZE>;
   using PipeMap   = etl::unordered_map<RequestId, PipeTransfer, CHIMERA_DMA_PIPE_QUEUE_SIZE>;
-  using ReqQueue  = etl::queue<RequestId, CHIMERA_DMA_MEM_QUEUE_SIZE, etl::memory_model::MEMORY_MODEL_SMALL>;
-  using PipeQueue = etl::queue<RequestId, CHIMERA_DMA_PIPE_QUEUE_SIZE, etl::memory_model::MEMORY_MODEL_SMALL>;
+  using PrioMap   = etl::unordered_map<RequestId, Priority, CHIMERA_DMA_MAX_PIPES>;
+  using ReqQueue  = PriorityQueue<CHIMERA_DMA_MEM_QUEUE_SIZE>;
+  using PipeQueue = PriorityQueue<CHIMERA_DMA_PIPE_QUEUE_SIZE>;
+  using StatArray = std::array<QueueLatency, NUM_PRIORITIES>;
+  using PipeSubmit = Chimera::Container::MPSCQueue<Submission<PipeTransfer>, CHIMERA_DMA_SUBMIT_QUEUE_SIZE>;
+  using MemSubmit  = Chimera::Container::MPSCQueue<Submission<MemTransfer>, CHIMERA_DMA_SUBMIT_QUEUE_SIZE>;
+  using TeleMap    = etl::unordered_map<RequestId, TrackedTelemetry, CHIMERA_DMA_TELEMETRY_MAX_REQUESTS>;
 
   /*-------------------------------------------------------------------------------
   Static Data
@@ -64,6 +275,8 @@ namespace Chimera::DMA::Util
   static Chimera::Thread::RecursiveMutex s_lock;
   static etl::random_xorshift s_rand_gen;
   static ReqSet s_uuid_set;
+  static QueueConfig s_queue_cfg = { QueuePolicy::STRICT, { 1, 2, 4, 8 }, 0 };
+  static StatArray s_latency;
 
   /*-------------------------------------------------
   Memory Request Transfers
@@ -76,7 +289,348 @@ namespace Chimera::DMA::Util
   -------------------------------------------------*/
   static PipeMap s_pipe_data;
   static PipeQueue s_pipe_queue;
+  static PrioMap s_pipe_priority;
+
+  /*-------------------------------------------------
+  ISR safe submissions, drained into the queues above
+  -------------------------------------------------*/
+  static PipeSubmit s_pipe_submit;
+  static MemSubmit s_mem_submit;
+  static std::atomic<size_t> s_submit_dropped;
+
+#if ( CHIMERA_DMA_TELEMETRY == CHIMERA_ENABLE )
+  /*-------------------------------------------------
+  Opt-in telemetry
+  -------------------------------------------------*/
+  static TelemetrySnapshot s_telemetry;
+  static TeleMap s_request_telemetry;
+  static size_t s_telemetry_tick;
+#endif /* CHIMERA_DMA_TELEMETRY */
+
+
+  /*-------------------------------------------------------------------------------
+  Static Functions
+  -------------------------------------------------------------------------------*/
+  /**
+   * @brief Records how long a request waited in the queue
+   *
+   * @param entry       The request that was just dequeued
+   * @param timestamp   Current system time in microseconds
+   * @return void
+   */
+  static void recordLatency( const QueueEntry &entry, const size_t timestamp )
+  {
+    QueueLatency &stats = s_latency[ EnumValue( entry.priority ) ];
+    size_t wait         = timestamp - entry.enqueuedAt;
+
+    stats.samples++;
+    stats.lastUs = wait;
+    stats.totalUs += wait;
+    stats.minUs = std::min( stats.minUs, wait );
+    stats.maxUs = std::max( stats.maxUs, wait );
+  }
+
+
+  /**
+   * @brief Looks up the priority level assigned to a pipe
+   *
+   * @param pipe        Which pipe to look up
+   * @return Priority
+   */
+  static Priority pipePriority( const RequestId pipe )
+  {
+    PrioMap::iterator iter = s_pipe_priority.find( pipe );
+    return ( iter == s_pipe_priority.end() ) ? Priority::LOW : iter->second;
+  }
+
+
+  /*-------------------------------------------------------------------------------
+  Telemetry Hooks
+  -------------------------------------------------------------------------------*/
+#if ( CHIMERA_DMA_TELEMETRY == CHIMERA_ENABLE )
+  /**
+   * @brief Gets the per-priority telemetry for a queue
+   *
+   * @param type        Which queue
+   * @param priority    Which level
+   * @return PriorityTelemetry &
+   */
+  static PriorityTelemetry &levelTelemetry( const QueueType type, const Priority priority )
+  {
+    auto &levels = ( type == QueueType::PIPE ) ? s_telemetry.pipe : s_telemetry.mem;
+    return levels[ EnumValue( priority ) ];
+  }
+
+
+  /**
+   * @brief Gets the counters for a request ID, adding it to the table if needed
+   *
+   * Every memory transfer gets a new ID, so a full table evicts the least
+   * recently updated entry rather than freezing on the first IDs it saw.
+   *
+   * @param id          Request to look up
+   * @return RequestTelemetry *   nullptr if the table holds no entries
+   */
+  static RequestTelemetry *requestTelemetry( const RequestId id )
+  {
+    s_telemetry_tick++;
+
+    TeleMap::iterator iter = s_request_telemetry.find( id );
+    if ( iter != s_request_telemetry.end() )
+    {
+      iter->second.lastUse = s_telemetry_tick;
+      return &iter->second.stats;
+    }
+
+    if ( s_request_telemetry.full() )
+    {
+      TeleMap::iterator oldest = s_request_telemetry.begin();
+      for ( iter = s_request_telemetry.begin(); iter != s_request_telemetry.end(); iter++ )
+      {
+        if ( ( s_telemetry_tick - iter->second.lastUse ) > ( s_telemetry_tick - oldest->second.lastUse ) )
+        {
+          oldest = iter;
+        }
+      }
+
+      if ( oldest == s_request_telemetry.end() )
+      {
+        return nullptr;
+      }
+
+      s_request_telemetry.erase( oldest );
+      s_telemetry.evicted++;
+    }
+
+    TrackedTelemetry fresh;
+    fresh.stats.clear();
+    fresh.lastUse = s_telemetry_tick;
+    return &s_request_telemetry.insert( { id, fresh } ).first->second.stats;
+  }
+
+
+  /**
+   * @brief Records a request entering a queue
+   *
+   * @param type        Which queue
+   * @param priority    Level the request was queued at
+   * @param depth       Queue depth after insertion
+   * @return void
+   */
+  static void telemetryEnqueue( const QueueType type, const Priority priority, const size_t depth )
+  {
+    PriorityTelemetry &level = levelTelemetry( type, priority );
+
+    level.depth     = depth;
+    level.peakDepth = std::max( level.peakDepth, depth );
+  }
+
+
+  /**
+   * @brief Records a request rejected because its queue was full
+   *
+   * @param type        Which queue
+   * @param id          Request that was rejected
+   * @param priority    Level the request was destined for
+   * @return void
+   */
+  static void telemetryFull( const QueueType type, const RequestId id, const Priority priority )
+  {
+    levelTelemetry( type, priority ).fullEvents++;
+
+    if ( RequestTelemetry *stats = requestTelemetry( id ); stats )
+    {
+      stats->enqueueFailures++;
+    }
+  }
+
+
+  /**
+   * @brief Records a request leaving the queue for the hardware
+   *
+   * @param type        Which queue
+   * @param entry       The request that was dequeued
+   * @param depth       Queue depth after removal
+   * @param bytes       Size of the transfer
+   * @param timestamp   Current system time in microseconds
+   * @return void
+   */
+  static void telemetryDispatch( const QueueType type, const QueueEntry &entry, const size_t depth, const size_t bytes,
+                                 const size_t timestamp )
+  {
+    PriorityTelemetry &level = levelTelemetry( type, entry.priority );
+    size_t wait              = timestamp - entry.enqueuedAt;
+    size_t bucket            = 0;
+
+    while ( ( wait >> ( bucket + 1 ) ) && ( bucket < ( LATENCY_BUCKETS - 1 ) ) )
+    {
+      bucket++;
+    }
+
+    level.latency.buckets[ bucket ]++;
+    level.depth = depth;
+
+    if ( RequestTelemetry *stats = requestTelemetry( entry.id ); stats )
+    {
+      stats->transfers++;
+      stats->bytes += bytes;
+    }
+  }
+#else
+  static inline void telemetryEnqueue( const QueueType, const Priority, const size_t )
+  {
+  }
+
+  static inline void telemetryFull( const QueueType, const RequestId, const Priority )
+  {
+  }
+
+  static inline void telemetryDispatch( const QueueType, const QueueEntry &, const size_t, const size_t, const size_t )
+  {
+  }
+#endif /* CHIMERA_DMA_TELEMETRY */
+
+
+  /**
+   * @brief Places a pipe transfer in its priority queue
+   *
+   * Must be called with the module lock held.
+   *
+   * @param transfer    The transfer to queue
+   * @param timestamp   When the transfer was requested, in microseconds
+   * @return bool
+   */
+  static bool enqueuePipe( const PipeTransfer &transfer, const size_t timestamp )
+  {
+    /*-------------------------------------------------
+    Ensure the pipe ID actually is registered
+    -------------------------------------------------*/
+    Priority priority = pipePriority( transfer.pipe );
+
+    if ( s_uuid_set.find( transfer.pipe ) == s_uuid_set.end() )
+    {
+      return false;
+    }
+
+    if ( s_pipe_data.full() || s_pipe_queue.full( priority ) )
+    {
+      telemetryFull( QueueType::PIPE, transfer.pipe, priority );
+      return false;
+    }
+
+    /*-------------------------------------------------
+    Enqueue the transaction, overwriting any previously
+    queued data for the request ID.
+    -------------------------------------------------*/
+    s_pipe_queue.push( transfer.pipe, priority, timestamp );
+    telemetryEnqueue( QueueType::PIPE, priority, s_pipe_queue.size( priority ) );
+
+    PipeMap::iterator iter = s_pipe_data.find( transfer.pipe );
+    if( iter == s_pipe_data.end() )
+    {
+      s_pipe_data.insert( { transfer.pipe, transfer } );
+    }
+    else
+    {
+      iter->second = transfer;
+    }
+
+    return true;
+  }
+
+
+  /**
+   * @brief Places a memory transfer in its priority queue
+   *
+   * Must be called with the module lock held.
+   *
+   * @param transfer    The transfer to queue
+   * @param timestamp   When the transfer was requested, in microseconds
+   * @return bool
+   */
+  static bool enqueueMem( const MemTransfer &transfer, const size_t timestamp )
+  {
+    /*-------------------------------------------------
+    Ensure the pipe ID actually is registered
+    -------------------------------------------------*/
+    if ( ( s_uuid_set.find( transfer.id ) == s_uuid_set.end() ) || ( transfer.priority >= Priority::NUM_OPTIONS ) )
+    {
+      return false;
+    }
+
+    if ( s_request_data.full() || s_request_queue.full( transfer.priority ) )
+    {
+      telemetryFull( QueueType::MEM, transfer.id, transfer.priority );
+      return false;
+    }
+
+    /*-------------------------------------------------
+    Enqueue the transaction, overwriting any previously
+    queued data for the request ID.
+    -------------------------------------------------*/
+    s_request_queue.push( transfer.id, transfer.priority, timestamp );
+    telemetryEnqueue( QueueType::MEM, transfer.priority, s_request_queue.size( transfer.priority ) );
+
+    MemMap::iterator iter = s_request_data.find( transfer.id );
+    if( iter == s_request_data.end() )
+    {
+      s_request_data.insert( { transfer.id, transfer } );
+    }
+    else
+    {
+      iter->second = transfer;
+    }
 
+    return true;
+  }
+
+
+  /**
+   * @brief Moves lock-free submissions into the priority queues
+   *
+   * Must be called with the module lock held. Submissions that aren't
+   * registered or don't fit in their queue are dropped and counted.
+   *
+   * @return size_t     Number of submissions accepted
+   */
+  static size_t drain()
+  {
+    size_t accepted = 0;
+    size_t dropped  = 0;
+
+    Submission<PipeTransfer> pipe;
+    while ( s_pipe_submit.pop( pipe ) )
+    {
+      if ( enqueuePipe( pipe.transfer, pipe.timestamp ) )
+      {
+        accepted++;
+      }
+      else
+      {
+        dropped++;
+      }
+    }
+
+    Submission<MemTransfer> mem;
+    while ( s_mem_submit.pop( mem ) )
+    {
+      if ( enqueueMem( mem.transfer, mem.timestamp ) )
+      {
+        accepted++;
+      }
+      else
+      {
+        dropped++;
+      }
+    }
+
+    if ( dropped )
+    {
+      s_submit_dropped.fetch_add( dropped, std::memory_order_relaxed );
+    }
+
+    return accepted;
+  }
 
   /*-------------------------------------------------------------------------------
   Public Functions
@@ -122,6 +676,23 @@ namespace Chimera::DMA::Util
   }
 
 
+  void releaseRequestId( const RequestId id )
+  {
+    using namespace Chimera::Thread;
+    LockGuard lck( s_lock );
+
+    s_uuid_set.erase( id );
+
+#if ( CHIMERA_DMA_TELEMETRY == CHIMERA_ENABLE )
+    /*-------------------------------------------------
+    The ID may be handed out again, so its counters
+    must not carry over to the next owner
+    -------------------------------------------------*/
+    s_request_telemetry.erase( id );
+#endif /* CHIMERA_DMA_TELEMETRY */
+  }
+
+
   void initializeQueues()
   {
     using namespace Chimera::Thread;
@@ -135,6 +706,23 @@ namespace Chimera::DMA::Util
 
     s_pipe_data.clear();
     s_pipe_queue.clear();
+    s_pipe_priority.clear();
+
+    s_pipe_submit.clear();
+    s_mem_submit.clear();
+    s_submit_dropped.store( 0, std::memory_order_relaxed );
+
+    /*-------------------------------------------------
+    Statistics are only meaningful for the current set
+    of queues. The queue policy is left untouched so it
+    can be configured before the driver initializes.
+    -------------------------------------------------*/
+    for ( auto &stats : s_latency )
+    {
+      stats.clear();
+    }
+
+    resetTelemetry();
 
     /*-------------------------------------------------
     Reset the UUID set list
@@ -149,31 +737,7 @@ namespace Chimera::DMA::Util
     using namespace Chimera::Thread;
     LockGuard lck( s_lock );
 
-    /*-------------------------------------------------
-    Ensure the pipe ID actually is registered
-    -------------------------------------------------*/
-    if ( ( s_uuid_set.find( transfer.pipe ) == s_uuid_set.end() ) || s_pipe_data.full() || s_pipe_queue.full() )
-    {
-      return false;
-    }
-
-    /*-------------------------------------------------
-    Enqueue the transaction, overwriting any previously
-    queued data for the request ID.
-    -------------------------------------------------*/
-    s_pipe_queue.push( transfer.pipe );
-
-    PipeMap::iterator iter = s_pipe_data.find( transfer.pipe );
-    if( iter == s_pipe_data.end() )
-    {
-      s_pipe_data.insert( { transfer.pipe, transfer } );
-    }
-    else
-    {
-      iter->second = transfer;
-    }
-
-    return true;
+    return enqueuePipe( transfer, Chimera::micros() );
   }
 
 
@@ -185,13 +749,18 @@ namespace Chimera::DMA::Util
     /*-------------------------------------------------
     Ensure the queue has something for us
     -------------------------------------------------*/
-    if( s_pipe_queue.empty() )
+    drain();
+
+    size_t now       = Chimera::micros();
+    QueueEntry entry = { INVALID_REQUEST, Priority::LOW, now };
+
+    if( !s_pipe_queue.pop( entry, s_queue_cfg, now ) )
     {
       return false;
     }
 
-    RequestId id = INVALID_REQUEST;
-    s_pipe_queue.pop_into( id );
+    RequestId id = entry.id;
+    recordLatency( entry, now );
 
     /*-------------------------------------------------
     Pull out the data from the pipe map into the user's
@@ -205,6 +774,8 @@ namespace Chimera::DMA::Util
 
     transfer = iter->second;
     iter->second = {};
+
+    telemetryDispatch( QueueType::PIPE, entry, s_pipe_queue.size( entry.priority ), transfer.size, now );
     return true;
   }
 
@@ -214,66 +785,210 @@ namespace Chimera::DMA::Util
     using namespace Chimera::Thread;
     LockGuard lck( s_lock );
 
+    return enqueueMem( transfer, Chimera::micros() );
+  }
+
+
+  bool nextMemTransfer( MemTransfer &transfer )
+  {
+    using namespace Chimera::Thread;
+    LockGuard lck( s_lock );
+
     /*-------------------------------------------------
-    Ensure the pipe ID actually is registered
+    Ensure the queue has something for us
     -------------------------------------------------*/
-    if ( ( s_uuid_set.find( transfer.id ) == s_uuid_set.end() ) || s_request_data.full() || s_request_queue.full() )
+    drain();
+
+    size_t now       = Chimera::micros();
+    QueueEntry entry = { INVALID_REQUEST, Priority::LOW, now };
+
+    if( !s_request_queue.pop( entry, s_queue_cfg, now ) )
     {
       return false;
     }
 
+    RequestId id = entry.id;
+    recordLatency( entry, now );
+
     /*-------------------------------------------------
-    Enqueue the transaction, overwriting any previously
-    queued data for the request ID.
+    Find the data and copy it to the user. Erase the
+    mapping from the memory queue as these transfers
+    aren't permanently mapped.
     -------------------------------------------------*/
-    s_request_queue.push( transfer.id );
+    MemMap::iterator iter = s_request_data.find( id );
+    if( ( id == INVALID_REQUEST ) || ( iter == s_request_data.end() ) )
+    {
+      return false;
+    }
 
-    MemMap::iterator iter = s_request_data.find( transfer.id );
-    if( iter == s_request_data.end() )
+    transfer = iter->second;
+    s_request_data.erase( iter );
+
+    telemetryDispatch( QueueType::MEM, entry, s_request_queue.size( entry.priority ), transfer.size, now );
+    return true;
+  }
+
+
+  bool submitPipeTransfer( const PipeTransfer &transfer )
+  {
+    /*-------------------------------------------------
+    Reject what can be checked without the lock. The
+    registration check has to wait for the drain.
+    -------------------------------------------------*/
+    if ( transfer.pipe == INVALID_REQUEST )
     {
-      s_request_data.insert( { transfer.id, transfer } );
+      return false;
     }
-    else
+
+    return s_pipe_submit.push( { transfer, Chimera::micros() } );
+  }
+
+
+  bool submitMemTransfer( const MemTransfer &transfer )
+  {
+    if ( ( transfer.id == INVALID_REQUEST ) || ( transfer.priority >= Priority::NUM_OPTIONS ) )
     {
-      iter->second = transfer;
+      return false;
     }
 
-    return true;
+    return s_mem_submit.push( { transfer, Chimera::micros() } );
   }
 
 
-  bool nextMemTransfer( MemTransfer &transfer )
+  size_t drainSubmissions()
   {
     using namespace Chimera::Thread;
     LockGuard lck( s_lock );
 
-    /*-------------------------------------------------
-    Ensure the queue has something for us
-    -------------------------------------------------*/
-    if( s_request_queue.empty() )
+    return drain();
+  }
+
+
+  size_t droppedSubmissions()
+  {
+    return s_submit_dropped.load( std::memory_order_relaxed );
+  }
+
+
+  bool setPipePriority( const RequestId pipe, const Priority priority )
+  {
+    using namespace Chimera::Thread;
+    LockGuard lck( s_lock );
+
+    if ( ( pipe == INVALID_REQUEST ) || ( priority >= Priority::NUM_OPTIONS ) )
     {
       return false;
     }
 
-    RequestId id = INVALID_REQUEST;
-    s_request_queue.pop_into( id );
-
     /*-------------------------------------------------
-    Find the data and copy it to the user. Erase the
-    mapping from the memory queue as these transfers
-    aren't permanently mapped.
+    LOW is the default for unmapped pipes, so it doesn't
+    need to hold one of the CHIMERA_DMA_MAX_PIPES slots
     -------------------------------------------------*/
-    MemMap::iterator iter = s_request_data.find( id );
-    if( ( id == INVALID_REQUEST ) || ( iter == s_request_data.end() ) )
+    PrioMap::iterator iter = s_pipe_priority.find( pipe );
+    if ( priority == Priority::LOW )
+    {
+      if ( iter != s_pipe_priority.end() )
+      {
+        s_pipe_priority.erase( iter );
+      }
+      return true;
+    }
+    else if ( iter != s_pipe_priority.end() )
+    {
+      iter->second = priority;
+      return true;
+    }
+    else if ( !s_pipe_priority.full() )
+    {
+      s_pipe_priority.insert( { pipe, priority } );
+      return true;
+    }
+
+    return false;
+  }
+
+
+  void configureQueues( const QueueConfig &config )
+  {
+    using namespace Chimera::Thread;
+    LockGuard lck( s_lock );
+
+    s_queue_cfg = config;
+  }
+
+
+  bool getQueueLatency( const Priority priority, QueueLatency &stats )
+  {
+    using namespace Chimera::Thread;
+    LockGuard lck( s_lock );
+
+    if ( priority >= Priority::NUM_OPTIONS )
     {
       return false;
     }
 
-    transfer = iter->second;
-    s_request_data.erase( iter );
+    stats = s_latency[ EnumValue( priority ) ];
+    return true;
+  }
+
+
+  void resetQueueLatency()
+  {
+    using namespace Chimera::Thread;
+    LockGuard lck( s_lock );
+
+    for ( auto &stats : s_latency )
+    {
+      stats.clear();
+    }
+  }
+
+
+  bool getTelemetry( TelemetrySnapshot &snapshot )
+  {
+#if ( CHIMERA_DMA_TELEMETRY == CHIMERA_ENABLE )
+    using namespace Chimera::Thread;
+    LockGuard lck( s_lock );
+
+    snapshot = s_telemetry;
+    return true;
+#else
+    snapshot.clear();
+    return false;
+#endif /* CHIMERA_DMA_TELEMETRY */
+  }
+
+
+  bool getRequestTelemetry( const RequestId id, RequestTelemetry &stats )
+  {
+#if ( CHIMERA_DMA_TELEMETRY == CHIMERA_ENABLE )
+    using namespace Chimera::Thread;
+    LockGuard lck( s_lock );
+
+    TeleMap::iterator iter = s_request_telemetry.find( id );
+    if ( iter == s_request_telemetry.end() )
+    {
+      return false;
+    }
 
+    stats = iter->second.stats;
     return true;
+#else
+    stats.clear();
+    return false;
+#endif /* CHIMERA_DMA_TELEMETRY */
   }
 
 
+  void resetTelemetry()
+  {
+#if ( CHIMERA_DMA_TELEMETRY == CHIMERA_ENABLE )
+    using namespace Chimera::Thread;
+    LockGuard lck( s_lock );
+
+    s_telemetry.clear();
+    s_request_telemetry.clear();
+#endif /* CHIMERA_DMA_TELEMETRY */
+  }
+
 }  // namespace Chimera::DMA::Util
@@ -41,6 +41,16 @@ namespace Chimera::DMA
      */
     RequestId genRequestId();
 
+    /**
+     * @brief Returns a request ID to the pool once it is no longer in use
+     *
+     * Also drops the ID's per-request telemetry.
+     *
+     * @param id            The ID to release
+     * @return void
+     */
+    void releaseRequestId( const RequestId id );
+
     void initializeQueues();
 
     bool enqueuePipeTransfer( PipeTransfer &transfer );
@@ -50,6 +60,131 @@ namespace Chimera::DMA
     bool enqueueMemTransfer( MemTransfer &transfer );
 
     bool nextMemTransfer( MemTransfer &transfer );
+
+    /**
+     * @brief Submits a pipe transfer without taking any locks
+     *
+     * Safe to call from both threads and ISRs. The request is moved into its
+     * priority queue the next time the backend drains the submissions, which
+     * nextPipeTransfer() does automatically. Whether the pipe is registered
+     * and its queue has room is only known then, see droppedSubmissions().
+     *
+     * @param transfer      The transfer to submit
+     * @return bool         False if the transfer is invalid or the submission queue is full
+     */
+    bool submitPipeTransfer( const PipeTransfer &transfer );
+
+    /**
+     * @brief Submits a memory transfer without taking any locks
+     *
+     * @see submitPipeTransfer
+     *
+     * @param transfer      The transfer to submit
+     * @return bool         False if the transfer is invalid or the submission queue is full
+     */
+    bool submitMemTransfer( const MemTransfer &transfer );
+
+    /**
+     * @brief Moves lock-free submissions into the priority queues
+     *
+     * Must not be called from an ISR. Invalid submissions, or those that don't
+     * fit in their priority queue, are dropped and counted.
+     *
+     * @return size_t       Number of submissions accepted
+     */
+    size_t drainSubmissions();
+
+    /**
+     * @brief Gets how many submissions were dropped while draining
+     *
+     * Cleared by initializeQueues().
+     *
+     * @return size_t       Dropped submissions since the queues were initialized
+     */
+    size_t droppedSubmissions();
+
+    /**
+     * @brief Assigns the queueing priority of transfers made on a pipe
+     *
+     * Pipes that were never assigned a priority are queued at Priority::LOW.
+     * Only pipes above LOW take up one of the CHIMERA_DMA_MAX_PIPES slots.
+     *
+     * @param pipe          Which pipe to configure
+     * @param priority      Priority level for all future transfers on the pipe
+     * @return bool         True if the priority was recorded, false if no slot is free
+     */
+    bool setPipePriority( const RequestId pipe, const Priority priority );
+
+    /**
+     * @brief Selects how requests are pulled from the priority levels
+     *
+     * @param config        Policy, weights, and aging settings
+     * @return void
+     */
+    void configureQueues( const QueueConfig &config );
+
+    /**
+     * @brief Gets the queue wait time statistics for a priority level
+     *
+     * @param priority      Which level to query
+     * @param stats         Output for the statistics
+     * @return bool         False if the priority level is invalid
+     */
+    bool getQueueLatency( const Priority priority, QueueLatency &stats );
+
+    /**
+     * @brief Clears the queue wait time statistics on all priority levels
+     * @return void
+     */
+    void resetQueueLatency();
+
+    /**
+     * @brief Copies out the queue depth, failure, and latency telemetry
+     *
+     * Only available when CHIMERA_DMA_TELEMETRY is enabled.
+     *
+     * @param snapshot      Output for the telemetry
+     * @return bool         False if telemetry is disabled
+     */
+    bool getTelemetry( TelemetrySnapshot &snapshot );
+
+    /**
+     * @brief Gets the throughput and failure counters for a single request ID
+     *
+     * Only the CHIMERA_DMA_TELEMETRY_MAX_REQUESTS most recently active IDs
+     * are tracked. Older ones are evicted and counted in the snapshot.
+     *
+     * @param id            Pipe or memory request to look up
+     * @param stats         Output for the counters
+     * @return bool         False if disabled or the ID isn't tracked
+     */
+    bool getRequestTelemetry( const RequestId id, RequestTelemetry &stats );
+
+    /**
+     * @brief Clears all telemetry, including the per-request table
+     * @return void
+     */
+    void resetTelemetry();
+
+    /**
+     * @brief Executes a pipe descriptor chain one segment at a time
+     *
+     * Used when the backend has no native linked-list support.
+     *
+     * @param transfer      The chain to execute
+     * @param submit        Backend function that starts a single transfer
+     * @return RequestId    ID of the logical request
+     */
+    RequestId emulateChain( const PipeChainTransfer &transfer, RequestId ( *submit )( const PipeTransfer & ) );
+
+    /**
+     * @brief Executes a memory descriptor chain one segment at a time
+     *
+     * @param transfer      The chain to execute
+     * @param submit        Backend function that starts a single transfer
+     * @return RequestId    ID of the logical request
+     */
+    RequestId emulateChain( const MemChainTransfer &transfer, RequestId ( *submit )( const MemTransfer & ) );
   }
 }  // namespace Chimera::DMA
 
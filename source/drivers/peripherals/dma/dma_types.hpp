@@ -13,6 +13,7 @@
 #define CHIMERA_DMA_TYPES_HPP
 
 /* STL Includes */
+#include <array>
 #include <cstdint>
 #include <cstring>
 #include <limits>
@@ -58,6 +59,14 @@ namespace Chimera::DMA
   -------------------------------------------------------------------------------*/
   static constexpr RequestId INVALID_REQUEST = std::numeric_limits<RequestId>::max();
 
+  /**
+   * @brief Number of log2 buckets in a latency histogram
+   *
+   * Bucket N counts waits in [2^N, 2^(N+1)) microseconds. Bucket zero also
+   * counts zero waits and the final bucket counts everything longer.
+   */
+  static constexpr size_t LATENCY_BUCKETS = 16;
+
   /*-------------------------------------------------------------------------------
   Enumerations
   -------------------------------------------------------------------------------*/
@@ -144,6 +153,18 @@ namespace Chimera::DMA
   };
 
 
+  /**
+   * @brief Policies for choosing which priority level services the next queued request
+   */
+  enum class QueuePolicy : uint8_t
+  {
+    STRICT,   /**< Always pull from the highest non-empty priority level */
+    WEIGHTED, /**< Pull from each level in proportion to its configured weight */
+
+    NUM_OPTIONS
+  };
+
+
   /**
    * @brief Kinds of errors that the hardware could throw
    */
@@ -231,6 +252,60 @@ namespace Chimera::DMA
   };
 
 
+  /**
+   * @brief A single contiguous memory region of a pipe descriptor chain
+   */
+  struct Segment
+  {
+    std::uintptr_t addr; /**< Source/destination memory address */
+    size_t size;         /**< Number of bytes in the region */
+  };
+
+
+  /**
+   * @brief A single contiguous copy of a memory descriptor chain
+   */
+  struct MemSegment
+  {
+    std::uintptr_t src; /**< Source address */
+    std::uintptr_t dst; /**< Destination address */
+    size_t size;        /**< Number of bytes */
+  };
+
+
+  /**
+   * @brief Scatter-gather transfer on a pre-constructed DMA pipe
+   *
+   * Moves a fragmented buffer through a pipe as a single logical request.
+   * Segments are executed in order and the callback fires once, after the
+   * last segment completes or the first one fails.
+   *
+   * @warning The segment list must remain valid until the callback fires
+   */
+  struct PipeChainTransfer
+  {
+    RequestId pipe;            /**< Which pipe this is destined for */
+    const Segment *segments;   /**< List of memory regions, in transfer order */
+    size_t numSegments;        /**< Number of entries in the segment list */
+    TransferCallback callback; /**< Optional callback to be invoked on completion or error */
+  };
+
+
+  /**
+   * @brief Scatter-gather Memory <-> Memory transfer request descriptor
+   *
+   * @warning The segment list must remain valid until the callback fires
+   */
+  struct MemChainTransfer
+  {
+    const MemSegment *segments; /**< List of copies, in transfer order */
+    size_t numSegments;         /**< Number of entries in the segment list */
+    Priority priority;          /**< Priority level of the transfer */
+    Alignment alignment;        /**< Transfer data alignment */
+    TransferCallback callback;  /**< Optional callback to be invoked on completion or error */
+  };
+
+
   /**
    * @brief Transfer statistics for reporting to callbacks
    */
@@ -242,6 +317,176 @@ namespace Chimera::DMA
   };
 
 
+  /*-------------------------------------------------------------------------------
+  Classes
+  -------------------------------------------------------------------------------*/
+  /**
+   * @brief Lightweight future for an asynchronous memory operation
+   *
+   * Handles refer to a small pool of in-flight operations. Once an operation
+   * completes its slot may be reused, after which the old handle continues to
+   * report completion but can no longer report errors.
+   */
+  class AsyncHandle
+  {
+  public:
+    /**
+     * @brief Constructs a handle to an operation that already completed
+     */
+    AsyncHandle();
+    AsyncHandle( const size_t slot, const size_t generation, const RequestId id );
+
+    /**
+     * @brief Checks if the operation has finished, successfully or not
+     * @return bool
+     */
+    bool isComplete() const;
+
+    /**
+     * @brief Checks if the operation finished with an error
+     * @return bool
+     */
+    bool hasError() const;
+
+    /**
+     * @brief Blocks the current thread until the operation completes
+     *
+     * @param timeout       How long to wait in milliseconds
+     * @return Chimera::Status_t  OK, FAIL on transfer error, or TIMEOUT
+     */
+    Chimera::Status_t wait( const size_t timeout ) const;
+
+    /**
+     * @brief DMA request executing the operation
+     * @return RequestId    INVALID_REQUEST if the CPU performed the operation
+     */
+    RequestId id() const;
+
+  private:
+    size_t mSlot;       /**< Index of the in-flight operation */
+    size_t mGeneration; /**< Slot usage count when the operation started */
+    RequestId mId;      /**< DMA request ID */
+  };
+
+
+  /**
+   * @brief Controls how queued transfers are pulled out of the priority levels
+   */
+  struct QueueConfig
+  {
+    QueuePolicy policy;                                              /**< Dequeue policy between levels */
+    std::array<uint8_t, EnumValue( Priority::NUM_OPTIONS )> weights; /**< WEIGHTED: requests served per level per round */
+    size_t agingThresholdUs;                                         /**< Wait that promotes a request. Zero disables. */
+
+    void clear()
+    {
+      policy           = QueuePolicy::STRICT;
+      weights          = { 1, 2, 4, 8 };
+      agingThresholdUs = 0;
+    }
+  };
+
+
+  /**
+   * @brief Queue wait time statistics for a single priority level
+   */
+  struct QueueLatency
+  {
+    size_t samples; /**< Number of requests dequeued at this level */
+    size_t lastUs;  /**< Wait time of the most recent request */
+    size_t minUs;   /**< Shortest observed wait time */
+    size_t maxUs;   /**< Longest observed wait time */
+    size_t totalUs; /**< Accumulated wait time, for computing the average */
+
+    void clear()
+    {
+      samples = 0;
+      lastUs  = 0;
+      minUs   = std::numeric_limits<size_t>::max();
+      maxUs   = 0;
+      totalUs = 0;
+    }
+  };
+
+
+  /**
+   * @brief Log-bucketed distribution of queue wait times
+   */
+  struct LatencyHistogram
+  {
+    std::array<uint32_t, LATENCY_BUCKETS> buckets; /**< Sample counts, see LATENCY_BUCKETS */
+
+    void clear()
+    {
+      buckets.fill( 0 );
+    }
+  };
+
+
+  /**
+   * @brief Telemetry for a single priority level of a transfer queue
+   */
+  struct PriorityTelemetry
+  {
+    LatencyHistogram latency; /**< Time spent waiting in the queue */
+    size_t depth;             /**< Requests currently queued */
+    size_t peakDepth;         /**< Most requests ever queued at once */
+    size_t fullEvents;        /**< Enqueue attempts rejected for lack of space */
+
+    void clear()
+    {
+      latency.clear();
+      depth      = 0;
+      peakDepth  = 0;
+      fullEvents = 0;
+    }
+  };
+
+
+  /**
+   * @brief Telemetry tracked for an individual request ID
+   */
+  struct RequestTelemetry
+  {
+    size_t transfers;       /**< Transfers dispatched to the hardware */
+    size_t bytes;           /**< Total bytes dispatched */
+    size_t enqueueFailures; /**< Enqueue attempts rejected for lack of space */
+
+    void clear()
+    {
+      transfers       = 0;
+      bytes           = 0;
+      enqueueFailures = 0;
+    }
+  };
+
+
+  /**
+   * @brief Point in time copy of the queue telemetry
+   */
+  struct TelemetrySnapshot
+  {
+    std::array<PriorityTelemetry, EnumValue( Priority::NUM_OPTIONS )> pipe; /**< Pipe transfer queue */
+    std::array<PriorityTelemetry, EnumValue( Priority::NUM_OPTIONS )> mem;  /**< Memory transfer queue */
+    size_t evicted;                                                         /**< IDs pushed out of the request table by newer ones */
+
+    void clear()
+    {
+      for ( auto &level : pipe )
+      {
+        level.clear();
+      }
+
+      for ( auto &level : mem )
+      {
+        level.clear();
+      }
+
+      evicted = 0;
+    }
+  };
+
+
   /*-------------------------------------------------------------------------------
   Backend Namespace
   -------------------------------------------------------------------------------*/
@@ -258,6 +503,14 @@ namespace Chimera::DMA
       RequestId ( *constructPipe )( const PipeConfig & );
       RequestId ( *memTransfer )( const MemTransfer & );
       RequestId ( *pipeTransfer )( const PipeTransfer & );
+
+      /**
+       *  Optional linked-list transfers. Leave as nullptr if the hardware
+       *  can't chain descriptors and Chimera will emulate the chain using
+       *  the single transfer functions.
+       */
+      RequestId ( *pipeChainTransfer )( const PipeChainTransfer & );
+      RequestId ( *memChainTransfer )( const MemChainTransfer & );
     };
   }  // namespace Backend
 
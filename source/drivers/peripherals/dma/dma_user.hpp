@@ -41,6 +41,9 @@ namespace Chimera::DMA
   /**
    * @brief Constructs a permanent DMA pipe
    *
+   * Fails if the pipe asks for a priority above LOW and CHIMERA_DMA_MAX_PIPES
+   * such pipes already exist.
+   *
    * @param config        Pipe configuration parameters
    * @return RequestId    Unique Id identifying the pipe
    */
@@ -65,6 +68,57 @@ namespace Chimera::DMA
    */
   RequestId transfer( const PipeTransfer &transfer );
 
+  /**
+   * @brief Makes a scatter-gather transfer request on a DMA pipe
+   *
+   * Uses the hardware's linked-list mode if the backend supports it,
+   * otherwise the segments are issued one at a time in software.
+   *
+   * @param transfer      Parameters describing the request
+   * @return RequestId    Unique ID identifying the request
+   */
+  RequestId transfer( const PipeChainTransfer &transfer );
+
+  /**
+   * @brief Makes a scatter-gather transfer request between memory
+   *
+   * @param transfer      Parameters describing the request
+   * @return RequestId    Unique ID identifying the request
+   */
+  RequestId transfer( const MemChainTransfer &transfer );
+
+  /**
+   * @brief Copies memory using DMA, returning before the copy finishes
+   *
+   * Bytes before and after the widest alignment both pointers share are copied
+   * by the CPU, leaving an aligned body for the DMA hardware. Copies smaller
+   * than CHIMERA_DMA_ASYNC_MIN_SIZE, or when no DMA is available, are done
+   * entirely by the CPU and the returned handle is already complete.
+   *
+   * @warning Neither buffer may be touched until the handle reports completion
+   *
+   * @param dst           Destination address
+   * @param src           Source address
+   * @param size          Number of bytes to copy
+   * @return AsyncHandle
+   */
+  AsyncHandle memcpyAsync( void *const dst, const void *const src, const size_t size );
+
+  /**
+   * @brief Fills memory using DMA, returning before the fill finishes
+   *
+   * The CPU seeds the start of the aligned body, then a descriptor chain
+   * repeatedly copies the already filled region forward, doubling each step.
+   *
+   * @warning The buffer may not be touched until the handle reports completion
+   *
+   * @param dst           Destination address
+   * @param value         Byte value to fill with
+   * @param size          Number of bytes to fill
+   * @return AsyncHandle
+   */
+  AsyncHandle memsetAsync( void *const dst, const uint8_t value, const size_t size );
+
 }  // namespace Chimera::DMA
 
 #endif /* !CHIMERA_DMA_HPP */
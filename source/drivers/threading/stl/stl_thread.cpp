@@ -9,6 +9,7 @@
  ********************************************************************************/
 
 /* STL Includes */
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <cstring>
@@ -37,6 +38,12 @@ namespace Chimera::Thread
   }
 
 
+  int hardwareConcurrency()
+  {
+    return std::max( static_cast<int>( std::thread::hardware_concurrency() ), 1 );
+  }
+
+
   bool sendTaskMsg( const TaskId id, const TaskMsg msg, const size_t timeout )
   {
     auto thread = getThread( id );